@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/commandbuffer.hpp"
+#include "core/descriptorset.hpp"
+#include "core/pipeline.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LSFG::Utils {
+
+    ///
+    /// Schedule compute dispatches and derive the barriers between them.
+    ///
+    /// Each dispatch reads the sampled images and writes the storage images of its
+    /// descriptor set. Dispatches are grouped into waves of mutually independent work,
+    /// with a single merged barrier in front of each wave, so that independent
+    /// dispatches may overlap on the GPU.
+    ///
+    /// The first access of every image is assumed to conflict with earlier submissions.
+    ///
+    class FrameGraph {
+    public:
+        /// Create a frame graph recording into a command buffer.
+        FrameGraph(const Core::CommandBuffer& buffer)
+                : commandBuffer(&buffer) {}
+
+        ///
+        /// Add a compute dispatch to the graph.
+        ///
+        /// @param pipeline Pipeline to dispatch
+        /// @param descriptorSet Descriptor set declaring the accessed images
+        /// @param x Number of groups in the X dimension
+        /// @param y Number of groups in the Y dimension
+        ///
+        void dispatch(const Core::Pipeline& pipeline, const Core::DescriptorSet& descriptorSet,
+            uint32_t x, uint32_t y);
+
+        ///
+        /// Record all dispatches and barriers into the command buffer.
+        ///
+        /// @return Number of pipeline barriers recorded.
+        ///
+        /// @throws std::logic_error if the command buffer is not in Recording state
+        ///
+        size_t build();
+    private:
+        struct Pass {
+            const Core::Pipeline* pipeline;
+            const Core::DescriptorSet* descriptorSet;
+            uint32_t x, y;
+            size_t wave;
+        };
+
+        const Core::CommandBuffer* commandBuffer;
+        std::vector<Pass> passes;
+    };
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/buffer.hpp"
 #include "core/commandbuffer.hpp"
 #include "core/commandpool.hpp"
 #include "core/descriptorpool.hpp"
@@ -19,51 +20,6 @@
 
 namespace LSFG::Utils {
 
-    ///
-    /// Insert memory barriers for images in a command buffer.
-    ///
-    /// @throws std::logic_error if the command buffer is not in Recording state
-    ///
-    class BarrierBuilder {
-    public:
-        /// Create a barrier builder.
-        BarrierBuilder(const Core::CommandBuffer& buffer)
-                : commandBuffer(&buffer) {
-            this->barriers.reserve(16); // this is performance critical
-        }
-
-        // Add a resource to the barrier builder.
-        BarrierBuilder& addR2W(Core::Image& image);
-        BarrierBuilder& addW2R(Core::Image& image);
-
-        // Add an optional resource to the barrier builder.
-        BarrierBuilder& addR2W(std::optional<Core::Image>& image) {
-            if (image.has_value()) this->addR2W(*image); return *this; }
-        BarrierBuilder& addW2R(std::optional<Core::Image>& image) {
-            if (image.has_value()) this->addW2R(*image); return *this; }
-
-        /// Add a list of resources to the barrier builder.
-        BarrierBuilder& addR2W(std::vector<Core::Image>& images) {
-            for (auto& image : images) this->addR2W(image); return *this; }
-        BarrierBuilder& addW2R(std::vector<Core::Image>& images) {
-            for (auto& image : images) this->addW2R(image); return *this; }
-
-        /// Add an array of resources to the barrier builder.
-        template<std::size_t N>
-        BarrierBuilder& addR2W(std::array<Core::Image, N>& images) {
-            for (auto& image : images) this->addR2W(image); return *this; }
-        template<std::size_t N>
-        BarrierBuilder& addW2R(std::array<Core::Image, N>& images) {
-            for (auto& image : images) this->addW2R(image); return *this; }
-
-        /// Finish building the barrier
-        void build() const;
-    private:
-        const Core::CommandBuffer* commandBuffer;
-
-        std::vector<VkImageMemoryBarrier2> barriers;
-    };
-
     ///
     /// Upload a DDS file to a Vulkan image.
     ///
@@ -90,6 +46,19 @@ namespace LSFG::Utils {
     ///
     void clearImage(const Core::Device& device, Core::Image& image, bool white = false);
 
+    ///
+    /// Record copying a timestamp into the constant buffers of a pass. The copy is ordered
+    /// after shaders reading the buffers earlier on the same queue and before later ones.
+    ///
+    /// @param buf Command buffer in Recording state.
+    /// @param source Buffer holding the timestamp.
+    /// @param offset Offset of the timestamp in the source buffer.
+    /// @param buffers Unique constant buffers to copy the timestamp into.
+    /// @return Number of pipeline barriers recorded.
+    ///
+    size_t copyTimestamp(const Core::CommandBuffer& buf, const Core::Buffer& source,
+        size_t offset, const std::vector<Core::Buffer>& buffers);
+
 }
 
 namespace LSFG {
@@ -99,10 +68,47 @@ namespace LSFG {
         Core::DescriptorPool descriptorPool;
 
         uint64_t generationCount;
+        bool variableCount{false}; // passes are set up for every count up to generationCount
+        bool dynamicTimestamps{false}; // pass timestamps are written every frame
+        uint64_t laneCount{1}; // generation passes are spread over this many compute queues
         float flowScale;
         bool isHdr;
+        bool pipelined{false}; // analysis runs on the priority queue, overlapping generation
 
         Pool::ShaderPool shaders;
         Pool::ResourcePool resources;
     };
 }
+
+namespace LSFG::Utils {
+
+    /// A generation pass set up by the shader chains.
+    struct PassSlot {
+        uint64_t pass; // index of the generated frame, selects the lane and output image
+        uint64_t count; // number of frames generated alongside it
+        float timestamp; // position between the previous and the next frame
+    };
+
+    ///
+    /// Get the generation passes the shader chains set up, indexed by slot.
+    ///
+    /// With a fixed generation count, slot i is pass i of generationCount passes.
+    /// With a variable count, every count up to generationCount gets its own passes,
+    /// as the timestamps depend on it. Pass i of count c then uses slot c * (c - 1) / 2 + i.
+    ///
+    /// @param vk The Vulkan instance to use.
+    /// @return The passes, indexed by slot.
+    ///
+    std::vector<PassSlot> getPassSlots(const Vulkan& vk);
+
+    ///
+    /// Get the slot of a generation pass.
+    ///
+    /// @param vk The Vulkan instance to use.
+    /// @param count The number of frames generated, generationCount unless variableCount is set.
+    /// @param pass The index of the pass.
+    /// @return The index into the result of getPassSlots.
+    ///
+    uint64_t getPassSlot(const Vulkan& vk, uint64_t count, uint64_t pass);
+
+}
@@ -48,6 +48,18 @@ namespace LSFG::Core {
             construct(device, data, usage);
         }
 
+        ///
+        /// Write to the buffer from the host.
+        ///
+        /// @param device Vulkan device
+        /// @param data Data to write
+        /// @param offset Offset in the buffer in bytes
+        /// @param size Number of bytes to write
+        ///
+        /// @throws LSFG::vulkan_error if the buffer cannot be mapped.
+        ///
+        void write(const Core::Device& device, const void* data, size_t offset, size_t size);
+
         /// Get the Vulkan handle.
         [[nodiscard]] auto handle() const { return *this->buffer; }
         /// Get the size of the buffer.
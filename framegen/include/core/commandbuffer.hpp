@@ -50,10 +50,15 @@ namespace LSFG::Core {
         ///
         /// Begin recording commands in the command buffer.
         ///
+        /// Command buffers recorded without VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        /// stay in Full state after submission and may be submitted again.
+        ///
+        /// @param usage Usage flags for the recording
+        ///
         /// @throws std::logic_error if the command buffer is in Empty state
         /// @throws LSFG::vulkan_error if beginning the command buffer fails.
         ///
-        void begin();
+        void begin(VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
         ///
         /// Dispatch a compute command.
@@ -93,6 +98,14 @@ namespace LSFG::Core {
             const std::vector<Semaphore>& signalSemaphores = {},
             std::optional<std::vector<uint64_t>> signalSemaphoreValues = std::nullopt);
 
+        ///
+        /// Mark the command buffer as submitted by other means.
+        ///
+        /// Only command buffers recorded with VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        /// leave the Full state.
+        ///
+        void markSubmitted();
+
         /// Get the state of the command buffer.
         [[nodiscard]] CommandBufferState getState() const { return *this->state; }
         /// Get the Vulkan handle.
@@ -106,6 +119,7 @@ namespace LSFG::Core {
         ~CommandBuffer() = default;
     private:
         std::shared_ptr<CommandBufferState> state;
+        std::shared_ptr<VkCommandBufferUsageFlags> usage;
         std::shared_ptr<VkCommandBuffer> commandBuffer;
     };
 
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan_core.h>
 
 #include <memory>
+#include <cstdint>
 
 namespace LSFG::Core {
 
@@ -21,10 +22,11 @@ namespace LSFG::Core {
         /// Create the descriptor pool.
         ///
         /// @param device Vulkan device
+        /// @param scale Multiplier for the pool limits, for devices setting up more passes
         ///
         /// @throws LSFG::vulkan_error if object creation fails.
         ///
-        DescriptorPool(const Core::Device& device);
+        DescriptorPool(const Core::Device& device, uint32_t scale = 1);
 
         /// Get the Vulkan handle.
         [[nodiscard]] auto handle() const { return *this->descriptorPool; }
@@ -27,6 +27,7 @@ namespace LSFG::Core {
     /// This class manages the lifetime of a Vulkan descriptor set.
     ///
     class DescriptorSet {
+        friend class DescriptorSetUpdateBuilder;
     public:
         DescriptorSet() noexcept = default;
 
@@ -57,6 +58,10 @@ namespace LSFG::Core {
         ///
         void bind(const CommandBuffer& commandBuffer, const Pipeline& pipeline) const;
 
+        /// Get the images read through the descriptor set.
+        [[nodiscard]] const auto& getSampledImages() const { return *this->sampledImages; }
+        /// Get the images written through the descriptor set.
+        [[nodiscard]] const auto& getStorageImages() const { return *this->storageImages; }
         /// Get the Vulkan handle.
         [[nodiscard]] auto handle() const { return *this->descriptorSet; }
 
@@ -68,6 +73,8 @@ namespace LSFG::Core {
         ~DescriptorSet() = default;
     private:
         std::shared_ptr<VkDescriptorSet> descriptorSet;
+        std::shared_ptr<std::vector<Image>> sampledImages;
+        std::shared_ptr<std::vector<Image>> storageImages;
     };
 
     ///
@@ -119,6 +126,8 @@ namespace LSFG::Core {
                 : descriptorSet(&descriptorSet), device(&device) {}
 
         std::vector<VkWriteDescriptorSet> entries;
+        std::vector<Image> sampledImages;
+        std::vector<Image> storageImages;
     };
 
 }
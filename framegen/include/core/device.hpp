@@ -6,6 +6,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace LSFG::Core {
 
@@ -21,19 +23,48 @@ namespace LSFG::Core {
         ///
         /// @param instance Vulkan instance
         /// @param deviceUUID The UUID of the Vulkan device to use.
+        /// @param queueCount Number of compute queues to create, limited by the queue family.
+        /// @param priorityQueue Whether to create an additional high priority compute queue.
         ///
         /// @throws LSFG::vulkan_error if object creation fails.
         ///
-        Device(const Instance& instance, uint64_t deviceUUID);
+        Device(const Instance& instance, uint64_t deviceUUID, uint32_t queueCount = 1,
+            bool priorityQueue = false);
+
+        ///
+        /// Use an existing device without taking ownership of it.
+        ///
+        /// Physical device properties are passed in, as the physical device handle
+        /// may not be usable through the loader when it comes from a layer.
+        ///
+        /// @param physicalDevice Physical device the device was created on
+        /// @param device Vulkan device
+        /// @param computeFamilyIdx Queue family index of the queue
+        /// @param queue Compute capable queue to submit to
+        /// @param properties Properties of the physical device
+        /// @param memoryProperties Memory properties of the physical device
+        ///
+        Device(VkPhysicalDevice physicalDevice, VkDevice device,
+            uint32_t computeFamilyIdx, VkQueue queue,
+            const VkPhysicalDeviceProperties& properties,
+            const VkPhysicalDeviceMemoryProperties& memoryProperties);
 
         /// Get the Vulkan handle.
         [[nodiscard]] auto handle() const { return *this->device; }
         /// Get the physical device associated with this logical device.
         [[nodiscard]] VkPhysicalDevice getPhysicalDevice() const { return this->physicalDevice; }
+        /// Get the properties of the physical device.
+        [[nodiscard]] const auto& getProperties() const { return this->properties; }
+        /// Get the memory properties of the physical device.
+        [[nodiscard]] const auto& getMemoryProperties() const { return this->memoryProperties; }
         /// Get the compute queue family index.
         [[nodiscard]] uint32_t getComputeFamilyIdx() const { return this->computeFamilyIdx; }
-        /// Get the compute queue.
-        [[nodiscard]] VkQueue getComputeQueue() const { return this->computeQueue; }
+        /// Get the first compute queue.
+        [[nodiscard]] VkQueue getComputeQueue() const { return this->computeQueues.front(); }
+        /// Get all compute queues, in creation order.
+        [[nodiscard]] const auto& getComputeQueues() const { return this->computeQueues; }
+        /// Get the high priority compute queue, if the queue family had room for one.
+        [[nodiscard]] auto getPriorityQueue() const { return this->priorityQueue; }
 
         // Trivially copyable, moveable and destructible
         Device(const Core::Device&) noexcept = default;
@@ -44,10 +75,13 @@ namespace LSFG::Core {
     private:
         std::shared_ptr<VkDevice> device;
         VkPhysicalDevice physicalDevice{};
+        VkPhysicalDeviceProperties properties{};
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
 
         uint32_t computeFamilyIdx{0};
 
-        VkQueue computeQueue{};
+        std::vector<VkQueue> computeQueues;
+        std::optional<VkQueue> priorityQueue;
     };
 
 }
@@ -48,6 +48,20 @@ namespace LSFG::Core {
         Image(const Core::Device& device, VkExtent2D extent, VkFormat format,
             VkImageUsageFlags usage, VkImageAspectFlags aspectFlags, int fd);
 
+        ///
+        /// Use an existing image without taking ownership of it.
+        ///
+        /// @param device Vulkan device the image was created on
+        /// @param image Vulkan image, which must outlive this object
+        /// @param extent Extent of the image in pixels.
+        /// @param format Vulkan format of the image
+        /// @param aspectFlags Aspect flags for the image view
+        ///
+        /// @throws LSFG::vulkan_error if object creation fails.
+        ///
+        Image(const Core::Device& device, VkImage image, VkExtent2D extent,
+            VkFormat format, VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT);
+
         /// Get the Vulkan handle.
         [[nodiscard]] auto handle() const { return *this->image; }
         /// Get the Vulkan device memory handle.
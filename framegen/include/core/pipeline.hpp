@@ -1,12 +1,15 @@
 #pragma once
 
 #include "core/commandbuffer.hpp"
+#include "core/pipelinecache.hpp"
 #include "core/shadermodule.hpp"
 #include "core/device.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <utility>
 #include <memory>
+#include <vector>
 
 namespace LSFG::Core {
 
@@ -20,7 +23,8 @@ namespace LSFG::Core {
         Pipeline() noexcept = default;
 
         ///
-        /// Create a compute pipeline.
+        /// Create the layout of a compute pipeline. The pipeline itself
+        /// must be compiled with Pipeline::compile before it is bound.
         ///
         /// @param device Vulkan device
         /// @param shader Shader module to use for the pipeline.
@@ -29,6 +33,20 @@ namespace LSFG::Core {
         ///
         Pipeline(const Core::Device& device, const ShaderModule& shader);
 
+        ///
+        /// Compile a batch of compute pipelines. The batch is split across
+        /// worker threads, each issuing a single multi-create call.
+        ///
+        /// @param device Vulkan device
+        /// @param pipelines Pipelines to compile, paired with their shader modules.
+        /// @param cache Pipeline cache to compile the pipelines with.
+        ///
+        /// @throws LSFG::vulkan_error if compilation fails.
+        ///
+        static void compile(const Core::Device& device,
+            const std::vector<std::pair<Pipeline, ShaderModule>>& pipelines,
+            const PipelineCache& cache);
+
         ///
         /// Bind the pipeline to a command buffer.
         ///
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/device.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LSFG::Core {
+
+    ///
+    /// C++ wrapper class for a Vulkan pipeline cache.
+    ///
+    /// This class manages the lifetime of a Vulkan pipeline cache.
+    ///
+    class PipelineCache {
+    public:
+        PipelineCache() noexcept = default;
+
+        ///
+        /// Create the pipeline cache, optionally loading it from disk.
+        ///
+        /// Cache files with a header not matching the device are discarded.
+        ///
+        /// @param device Vulkan device
+        /// @param path Path to the cache file, or empty for an in-memory cache.
+        ///
+        /// @throws LSFG::vulkan_error if object creation fails.
+        ///
+        PipelineCache(const Core::Device& device, const std::string& path);
+
+        ///
+        /// Write the pipeline cache to disk.
+        ///
+        /// @param device Vulkan device
+        /// @param path Path to the cache file.
+        ///
+        /// @throws LSFG::vulkan_error if the cache data cannot be retrieved.
+        /// @throws std::system_error if the file cannot be written.
+        ///
+        void save(const Core::Device& device, const std::string& path) const;
+
+        /// Get the Vulkan handle.
+        [[nodiscard]] auto handle() const { return *this->pipelineCache; }
+
+        /// Trivially copyable, moveable and destructible
+        PipelineCache(const PipelineCache&) noexcept = default;
+        PipelineCache& operator=(const PipelineCache&) noexcept = default;
+        PipelineCache(PipelineCache&&) noexcept = default;
+        PipelineCache& operator=(PipelineCache&&) noexcept = default;
+        ~PipelineCache() = default;
+    private:
+        std::shared_ptr<VkPipelineCache> pipelineCache;
+    };
+
+}
@@ -34,10 +34,20 @@ namespace LSFG::Core {
         ///
         /// @param device Vulkan device
         /// @param fd File descriptor to import the semaphore from.
+        /// @param timeline Whether the imported semaphore is a timeline semaphore.
         ///
         /// @throws LSFG::vulkan_error if object creation fails.
         ///
-        Semaphore(const Core::Device& device, int fd);
+        Semaphore(const Core::Device& device, int fd, bool timeline = false);
+
+        ///
+        /// Use an existing semaphore without taking ownership of it.
+        ///
+        /// @param device Vulkan device the semaphore was created on
+        /// @param semaphore Vulkan semaphore, which must outlive this object
+        /// @param timeline Whether the semaphore is a timeline semaphore.
+        ///
+        Semaphore(const Core::Device& device, VkSemaphore semaphore, bool timeline = true);
 
         ///
         /// Signal the semaphore to a specific value.
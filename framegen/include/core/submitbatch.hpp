@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/commandbuffer.hpp"
+#include "core/semaphore.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace LSFG::Core {
+
+    ///
+    /// Collect command buffers and submit them with a single vkQueueSubmit2 call.
+    ///
+    /// Every added command buffer becomes its own VkSubmitInfo2 entry, waits and
+    /// signals apply to the most recently added submission. The batch keeps
+    /// its storage between submissions, so reusing it avoids per-frame allocations.
+    ///
+    class SubmitBatch {
+    public:
+        SubmitBatch() noexcept = default;
+
+        ///
+        /// Add a command buffer as a new submission.
+        ///
+        /// @param buffer Command buffer to submit
+        ///
+        /// @throws std::logic_error if the command buffer is not in Full state.
+        ///
+        SubmitBatch& add(const CommandBuffer& buffer);
+
+        ///
+        /// Add a submission without a command buffer, which only forwards semaphores.
+        ///
+        SubmitBatch& add();
+
+        ///
+        /// Wait for a semaphore before executing the last added submission.
+        ///
+        /// @param semaphore Semaphore to wait on
+        /// @param value Value to wait for, ignored for binary semaphores
+        /// @param stage Pipeline stages that wait for the semaphore
+        ///
+        /// @throws std::logic_error if no submission was added.
+        ///
+        SubmitBatch& wait(const Semaphore& semaphore, uint64_t value,
+            VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+        ///
+        /// Signal a semaphore after executing the last added submission.
+        ///
+        /// @param semaphore Semaphore to signal
+        /// @param value Value to signal, ignored for binary semaphores
+        /// @param stage Pipeline stages that have to complete before signaling
+        ///
+        /// @throws std::logic_error if no submission was added.
+        ///
+        SubmitBatch& signal(const Semaphore& semaphore, uint64_t value,
+            VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+        ///
+        /// Submit all collected submissions and clear the batch.
+        ///
+        /// @param queue Vulkan queue to submit to
+        ///
+        /// @throws LSFG::vulkan_error if submission fails.
+        ///
+        void submit(VkQueue queue);
+
+        /// Get the number of collected submissions.
+        [[nodiscard]] size_t size() const { return this->entries.size(); }
+
+        // Trivially copyable, moveable and destructible
+        SubmitBatch(const SubmitBatch&) = default;
+        SubmitBatch& operator=(const SubmitBatch&) = default;
+        SubmitBatch(SubmitBatch&&) = default;
+        SubmitBatch& operator=(SubmitBatch&&) = default;
+        ~SubmitBatch() = default;
+    private:
+        struct Entry {
+            size_t bufferOffset;
+            size_t bufferCount;
+            size_t waitOffset;
+            size_t waitCount;
+            size_t signalOffset;
+            size_t signalCount;
+        };
+
+        std::vector<CommandBuffer> buffers;
+        std::vector<VkCommandBufferSubmitInfo> bufferInfos;
+        std::vector<VkSemaphoreSubmitInfo> waits;
+        std::vector<VkSemaphoreSubmitInfo> signals;
+        std::vector<Entry> entries;
+        std::vector<VkSubmitInfo2> submitInfos;
+    };
+
+}
@@ -6,6 +6,7 @@
 
 #include "vulkan/vulkan_core.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 
@@ -35,13 +36,19 @@ namespace LSFG::Pool {
         /// @param timestamp Timestamp stored in buffer
         /// @param firstIter First iteration stored in buffer
         /// @param firstIterS First special iteration stored in buffer
+        /// @param unique Create a buffer that is not shared, so that its timestamp
+        ///     can be overwritten at TIMESTAMP_OFFSET with transfer commands
         /// @return Created or cached buffer
         ///
         /// @throws LSFG::vulkan_error if the buffer cannot be created.
         ///
         Core::Buffer getBuffer(
             const Core::Device& device,
-            float timestamp = 0.0F, bool firstIter = false, bool firstIterS = false);
+            float timestamp = 0.0F, bool firstIter = false, bool firstIterS = false,
+            bool unique = false);
+
+        /// Offset of the timestamp in buffers, in bytes.
+        static constexpr size_t TIMESTAMP_OFFSET = 28;
 
         ///
         /// Retrieve a sampler by type or create it.
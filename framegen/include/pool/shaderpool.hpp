@@ -2,6 +2,7 @@
 
 #include "core/device.hpp"
 #include "core/pipeline.hpp"
+#include "core/pipelinecache.hpp"
 #include "core/shadermodule.hpp"
 
 #include <vulkan/vulkan_core.h>
@@ -19,6 +20,9 @@ namespace LSFG::Pool {
     ///
     /// Shader pool for each Vulkan device.
     ///
+    /// Shader modules and pipelines are content-addressed, so names
+    /// resolving to identical bytecode share the same Vulkan objects.
+    ///
     class ShaderPool {
     public:
         ShaderPool() noexcept = default;
@@ -27,11 +31,13 @@ namespace LSFG::Pool {
         /// Create the shader pool.
         ///
         /// @param source Function to retrieve shader source code by name.
+        /// @param cache Pipeline cache to compile pipelines with.
         ///
         /// @throws std::runtime_error if the shader pool cannot be created.
         ///
-        ShaderPool(const std::function<std::vector<uint8_t>(const std::string&)>& source)
-            : source(source) {}
+        ShaderPool(const std::function<std::vector<uint8_t>(const std::string&)>& source,
+                Core::PipelineCache cache)
+            : source(source), cache(std::move(cache)) {}
 
         ///
         /// Retrieve a shader module by name or create it.
@@ -49,6 +55,9 @@ namespace LSFG::Pool {
         ///
         /// Retrieve a pipeline shader module by name or create it.
         ///
+        /// Newly created pipelines are only compiled once createPipelines is called,
+        /// so they must not be bound before that.
+        ///
         /// @param name Name of the shader module
         /// @return Pipeline shader module or empty
         ///
@@ -56,10 +65,33 @@ namespace LSFG::Pool {
         ///
         Core::Pipeline getPipeline(
             const Core::Device& device, const std::string& name);
+
+        ///
+        /// Compile all pipelines requested since the last call in one batch.
+        ///
+        /// @throws LSFG::vulkan_error if a pipeline cannot be compiled.
+        ///
+        void createPipelines(const Core::Device& device);
+
+        /// Get the pipeline cache.
+        [[nodiscard]] const auto& getPipelineCache() const { return this->cache; }
+        /// Check whether pipelines were compiled since the last call, then reset the flag.
+        [[nodiscard]] bool takeDirty() { return std::exchange(this->dirty, false); }
     private:
         std::function<std::vector<uint8_t>(const std::string&)> source;
-        std::unordered_map<std::string, Core::ShaderModule> shaders;
-        std::unordered_map<std::string, Core::Pipeline> pipelines;
+        Core::PipelineCache cache;
+        bool dirty{false};
+        /// Shader module with the inputs it was created from, to tell hash collisions apart.
+        struct ShaderEntry {
+            Core::ShaderModule module;
+            std::vector<uint8_t> bytecode;
+            std::vector<std::pair<size_t, VkDescriptorType>> types;
+        };
+
+        std::unordered_map<std::string, uint64_t> keys;
+        std::unordered_map<uint64_t, ShaderEntry> shaders;
+        std::unordered_map<uint64_t, Core::Pipeline> pipelines;
+        std::vector<std::pair<Core::Pipeline, Core::ShaderModule>> pendingPipelines;
     };
 
 }
@@ -10,19 +10,64 @@
 namespace LSFG_3_1P {
 
     ///
-    /// Initialize the LSFG library.
+    /// Initialize the LSFG library. Calling this again with the same parameters does
+    /// nothing; with different parameters, the library is finalized and initialized again.
     ///
     /// @param deviceUUID The UUID of the Vulkan device to use.
     /// @param isHdr Whether the images are in HDR format.
     /// @param flowScale Internal flow scale factor.
     /// @param generationCount Number of frames to generate.
+    /// @param variableCount Whether frames may generate fewer than generationCount frames.
+    /// @param dynamicTimestamps Whether the timestamps of generated frames are passed every frame.
+    /// @param multiQueue Whether to spread generation passes over several compute queues,
+    ///     at the cost of separate temporary images for each queue.
+    /// @param pipelined Whether to analyze new frames on a separate high priority queue,
+    ///     overlapping with generation of the previous frame.
     /// @param loader Function to load shader source code by name.
+    /// @param cacheDirectory Directory to persist the pipeline cache in, or empty to disable it.
     ///
-    /// @throws LSFG::vulkan_error if Vulkan objects fail to initialize.
+    /// @throws LSFG::vulkan_error if Vulkan objects fail to initialize, or if contexts
+    ///     still exist while the parameters change.
     ///
     void initialize(uint64_t deviceUUID,
-        bool isHdr, float flowScale, uint64_t generationCount,
-        const std::function<std::vector<uint8_t>(const std::string&)>& loader);
+        bool isHdr, float flowScale, uint64_t generationCount, bool variableCount,
+        bool dynamicTimestamps, bool multiQueue, bool pipelined,
+        const std::function<std::vector<uint8_t>(const std::string&)>& loader,
+        const std::string& cacheDirectory);
+
+    ///
+    /// Initialize the LSFG library on an existing device, instead of creating its own.
+    ///
+    /// The device must have timeline semaphores, synchronization2, the Vulkan memory model
+    /// and null descriptors enabled. All work is submitted to the given queue, which must
+    /// not be used concurrently while LSFG functions are running. Calling either
+    /// initialization function again behaves as described for initialize.
+    ///
+    /// @param physicalDevice The physical device the device was created on.
+    /// @param device The Vulkan device to use.
+    /// @param queueFamily The queue family index of the queue.
+    /// @param queue A compute capable queue to submit to.
+    /// @param properties The properties of the physical device.
+    /// @param memoryProperties The memory properties of the physical device.
+    /// @param isHdr Whether the images are in HDR format.
+    /// @param flowScale Internal flow scale factor.
+    /// @param generationCount Number of frames to generate.
+    /// @param variableCount Whether frames may generate fewer than generationCount frames.
+    /// @param dynamicTimestamps Whether the timestamps of generated frames are passed every frame.
+    /// @param loader Function to load shader source code by name.
+    /// @param cacheDirectory Directory to persist the pipeline cache in, or empty to disable it.
+    ///
+    /// @throws LSFG::vulkan_error if Vulkan objects fail to initialize, or if contexts
+    ///     still exist while the parameters change.
+    ///
+    void initializeShared(VkPhysicalDevice physicalDevice, VkDevice device,
+        uint32_t queueFamily, VkQueue queue,
+        const VkPhysicalDeviceProperties& properties,
+        const VkPhysicalDeviceMemoryProperties& memoryProperties,
+        bool isHdr, float flowScale, uint64_t generationCount, bool variableCount,
+        bool dynamicTimestamps,
+        const std::function<std::vector<uint8_t>(const std::string&)>& loader,
+        const std::string& cacheDirectory);
 
     ///
     /// Create a new LSFG context on a swapchain.
@@ -32,24 +77,69 @@ namespace LSFG_3_1P {
     /// @param outN File descriptor for each output image. This defines the LSFG level.
     /// @param extent The size of the images
     /// @param format The format of the images.
+    /// @param inFormat The format of the input images, which are only ever sampled.
+    /// @param inSem File descriptor for a timeline semaphore that reaches n + 1
+    ///     once input frame n is ready, or -1.
+    /// @param outSem File descriptor for a timeline semaphore that reaches
+    ///     n * generationCount + i + 1 once output image i of frame n is ready, or -1.
     /// @return A unique identifier for the created context.
     ///
     /// @throws LSFG::vulkan_error if the context cannot be created.
     ///
     int32_t createContext(
         int in0, int in1, const std::vector<int>& outN,
-        VkExtent2D extent, VkFormat format);
+        VkExtent2D extent, VkFormat format, VkFormat inFormat,
+        int inSem, int outSem);
 
     ///
-    /// Present a context.
+    /// Create a new LSFG context from images and semaphores of the device passed
+    /// to initializeShared.
+    ///
+    /// @param in0 The first input image.
+    /// @param in1 The second input image.
+    /// @param outN The output images. This defines the LSFG level.
+    /// @param extent The size of the images
+    /// @param format The format of the images.
+    /// @param inFormat The format of the input images, which are only ever sampled.
+    /// @param inSem Timeline semaphore that reaches n + 1 once input frame n is ready.
+    /// @param outSem Timeline semaphore that reaches n * generationCount + i + 1
+    ///     once output image i of frame n is ready.
+    /// @return A unique identifier for the created context.
+    ///
+    /// @throws LSFG::vulkan_error if the context cannot be created.
+    ///
+    int32_t createSharedContext(
+        VkImage in0, VkImage in1, const std::vector<VkImage>& outN,
+        VkExtent2D extent, VkFormat format, VkFormat inFormat,
+        VkSemaphore inSem, VkSemaphore outSem);
+
+    ///
+    /// Present a context, generating the next set of frames.
+    ///
+    /// Timestamps are spread evenly over the passes that run. Pass i of frame n signals the
+    /// output semaphore to n * generationCount + i + 1, except for the last pass, which
+    /// signals (n + 1) * generationCount. The first frames of a context always run every pass.
     ///
     /// @param id Unique identifier of the context to present.
-    /// @param inSem Semaphore to wait on before starting the generation.
-    /// @param outSem Semaphores to signal once each output image is ready.
+    /// @param passCount Number of frames to generate, generationCount unless variableCount is set.
+    /// @param timestamps With dynamicTimestamps, the position of each generated frame between
+    ///     the previous (0) and the next frame (1). Empty or mismatched spaces them evenly.
+    /// @return The number of frames that are generated.
     ///
     /// @throws LSFG::vulkan_error if the context cannot be presented.
+    /// @throws std::logic_error if the pass count is invalid.
+    ///
+    uint64_t presentContext(int32_t id, uint64_t passCount, const std::vector<float>& timestamps);
+
+    ///
+    /// Get the number of pipeline barriers a context records per frame.
+    ///
+    /// @param id Unique identifier of the context.
+    /// @return Number of barriers across all command buffers of one frame.
+    ///
+    /// @throws LSFG::vulkan_error if the context does not exist.
     ///
-    void presentContext(int32_t id, int inSem, const std::vector<int>& outSem);
+    uint64_t getBarrierCount(int32_t id);
 
     ///
     /// Delete an LSFG context.
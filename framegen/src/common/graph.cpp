@@ -0,0 +1,153 @@
+#include "common/graph.hpp"
+#include "core/commandbuffer.hpp"
+#include "core/descriptorset.hpp"
+#include "core/pipeline.hpp"
+#include "core/image.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace LSFG;
+using namespace LSFG::Utils;
+
+namespace {
+    /// Last access of an image recorded into the command buffer.
+    enum class Access { Unknown, Read, Write };
+
+    struct ImageState {
+        Core::Image image;
+        size_t readEnd{0}; // one past the last wave reading the image
+        size_t writeEnd{0}; // one past the last wave writing the image
+        Access recorded{Access::Unknown};
+    };
+
+    struct WaveAccess {
+        ImageState* state;
+        bool read;
+        bool write;
+    };
+}
+
+void FrameGraph::dispatch(const Core::Pipeline& pipeline, const Core::DescriptorSet& descriptorSet,
+        uint32_t x, uint32_t y) {
+    this->passes.push_back({
+        .pipeline = &pipeline,
+        .descriptorSet = &descriptorSet,
+        .x = x, .y = y,
+        .wave = 0
+    });
+}
+
+size_t FrameGraph::build() {
+    if (this->commandBuffer->getState() != Core::CommandBufferState::Recording)
+        throw std::logic_error("Command buffer is not in Recording state");
+
+    // place every pass in the first wave after all passes it conflicts with
+    std::unordered_map<VkImage, ImageState> images;
+    auto getState = [&images](const Core::Image& image) -> ImageState& {
+        return images.try_emplace(image.handle(), ImageState{ .image = image }).first->second;
+    };
+
+    size_t waveCount = 0;
+    for (auto& pass : this->passes) {
+        size_t wave = 0;
+        for (const auto& image : pass.descriptorSet->getSampledImages())
+            wave = std::max(wave, getState(image).writeEnd);
+        for (const auto& image : pass.descriptorSet->getStorageImages()) {
+            const auto& state = getState(image);
+            wave = std::max({ wave, state.writeEnd, state.readEnd });
+        }
+
+        for (const auto& image : pass.descriptorSet->getSampledImages()) {
+            auto& state = getState(image);
+            state.readEnd = std::max(state.readEnd, wave + 1);
+        }
+        for (const auto& image : pass.descriptorSet->getStorageImages())
+            getState(image).writeEnd = wave + 1;
+
+        pass.wave = wave;
+        waveCount = std::max(waveCount, wave + 1);
+    }
+
+    std::vector<std::vector<const Pass*>> waves(waveCount);
+    for (const auto& pass : this->passes)
+        waves.at(pass.wave).push_back(&pass);
+
+    // record each wave behind a single merged barrier
+    size_t barrierCount = 0;
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+    std::unordered_map<VkImage, WaveAccess> accesses;
+    std::vector<VkImageMemoryBarrier2> barriers;
+    for (const auto& wave : waves) {
+        accesses.clear();
+        for (const auto* pass : wave) {
+            for (const auto& image : pass->descriptorSet->getSampledImages())
+                accesses.try_emplace(image.handle(), WaveAccess{ &getState(image), false, false })
+                    .first->second.read = true;
+            for (const auto& image : pass->descriptorSet->getStorageImages())
+                accesses.try_emplace(image.handle(), WaveAccess{ &getState(image), false, false })
+                    .first->second.write = true;
+        }
+
+        barriers.clear();
+        for (auto& [handle, access] : accesses) {
+            auto& state = *access.state;
+
+            // reading an image that was only read before needs no barrier
+            if (!access.write && state.recorded == Access::Read
+                    && state.image.getLayout() == VK_IMAGE_LAYOUT_GENERAL)
+                continue;
+
+            VkAccessFlags2 dstAccess = VK_ACCESS_2_NONE;
+            if (access.read) dstAccess |= VK_ACCESS_2_SHADER_READ_BIT;
+            if (access.write) dstAccess |= VK_ACCESS_2_SHADER_WRITE_BIT;
+
+            barriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                .srcAccessMask = state.recorded == Access::Read
+                    ? VK_ACCESS_2_NONE : VK_ACCESS_2_SHADER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                .dstAccessMask = dstAccess,
+                .oldLayout = state.image.getLayout(),
+                .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+                .image = handle,
+                .subresourceRange = {
+                    .aspectMask = state.image.getAspectFlags(),
+                    .levelCount = 1,
+                    .layerCount = 1
+                }
+            });
+            state.image.setLayout(VK_IMAGE_LAYOUT_GENERAL);
+            state.recorded = access.write ? Access::Write : Access::Read;
+        }
+
+        if (!barriers.empty()) {
+            const VkDependencyInfo dependencyInfo = {
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size()),
+                .pImageMemoryBarriers = barriers.data()
+            };
+            vkCmdPipelineBarrier2(this->commandBuffer->handle(), &dependencyInfo);
+            barrierCount++;
+        }
+
+        for (const auto* pass : wave) {
+            if (pass->pipeline->handle() != boundPipeline) {
+                pass->pipeline->bind(*this->commandBuffer);
+                boundPipeline = pass->pipeline->handle();
+            }
+            pass->descriptorSet->bind(*this->commandBuffer, *pass->pipeline);
+            this->commandBuffer->dispatch(pass->x, pass->y, 1);
+        }
+    }
+
+    this->passes.clear();
+    return barrierCount;
+}
@@ -1,5 +1,6 @@
 #include "common/utils.hpp"
 #include "core/buffer.hpp"
+#include "core/commandbuffer.hpp"
 #include "core/image.hpp"
 #include "core/device.hpp"
 #include "core/commandpool.hpp"
@@ -8,6 +9,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cerrno>
 #include <cstdlib>
@@ -20,57 +23,6 @@
 using namespace LSFG;
 using namespace LSFG::Utils;
 
-BarrierBuilder& BarrierBuilder::addR2W(Core::Image& image) {
-    this->barriers.emplace_back(VkImageMemoryBarrier2 {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
-        .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-        .srcAccessMask = VK_ACCESS_2_SHADER_READ_BIT,
-        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-        .dstAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
-        .oldLayout = image.getLayout(),
-        .newLayout = VK_IMAGE_LAYOUT_GENERAL,
-        .image = image.handle(),
-        .subresourceRange = {
-            .aspectMask = image.getAspectFlags(),
-            .levelCount = 1,
-            .layerCount = 1
-        }
-    });
-    image.setLayout(VK_IMAGE_LAYOUT_GENERAL);
-
-    return *this;
-}
-
-BarrierBuilder& BarrierBuilder::addW2R(Core::Image& image) {
-    this->barriers.emplace_back(VkImageMemoryBarrier2 {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
-        .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-        .srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
-        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-        .dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT,
-        .oldLayout = image.getLayout(),
-        .newLayout = VK_IMAGE_LAYOUT_GENERAL,
-        .image = image.handle(),
-        .subresourceRange = {
-            .aspectMask = image.getAspectFlags(),
-            .levelCount = 1,
-            .layerCount = 1
-        }
-    });
-    image.setLayout(VK_IMAGE_LAYOUT_GENERAL);
-
-    return *this;
-}
-
-void BarrierBuilder::build() const {
-    const VkDependencyInfo dependencyInfo = {
-        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-        .imageMemoryBarrierCount = static_cast<uint32_t>(this->barriers.size()),
-        .pImageMemoryBarriers = this->barriers.data()
-    };
-    vkCmdPipelineBarrier2(this->commandBuffer->handle(), &dependencyInfo);
-}
-
 void Utils::uploadImage(const Core::Device& device, const Core::CommandPool& commandPool,
         Core::Image& image, const std::string& path) {
     // read image bytecode
@@ -188,3 +140,64 @@ void Utils::clearImage(const Core::Device& device, Core::Image& image, bool whit
     if (!fence.wait(device))
         throw LSFG::vulkan_error(VK_TIMEOUT, "Failed to wait for clearing fence.");
 }
+
+size_t Utils::copyTimestamp(const Core::CommandBuffer& buf, const Core::Buffer& source,
+        size_t offset, const std::vector<Core::Buffer>& buffers) {
+    // wait for earlier reads, then make the new timestamp visible to the shaders
+    const std::array<VkMemoryBarrier2, 2> barriers{{
+        {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_2_UNIFORM_READ_BIT
+        }
+    }};
+    const VkDependencyInfo readDependency{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &barriers.at(0)
+    };
+    vkCmdPipelineBarrier2(buf.handle(), &readDependency);
+
+    const VkBufferCopy region{
+        .srcOffset = offset,
+        .dstOffset = Pool::ResourcePool::TIMESTAMP_OFFSET,
+        .size = sizeof(float)
+    };
+    for (const auto& buffer : buffers)
+        vkCmdCopyBuffer(buf.handle(), source.handle(), buffer.handle(), 1, &region);
+
+    const VkDependencyInfo writeDependency{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &barriers.at(1)
+    };
+    vkCmdPipelineBarrier2(buf.handle(), &writeDependency);
+    return 2;
+}
+
+std::vector<PassSlot> Utils::getPassSlots(const Vulkan& vk) {
+    std::vector<PassSlot> slots;
+    for (uint64_t count = vk.variableCount ? 1 : vk.generationCount;
+            count <= vk.generationCount; count++)
+        for (uint64_t pass = 0; pass < count; pass++)
+            slots.push_back({
+                .pass = pass,
+                .count = count,
+                .timestamp = static_cast<float>(pass + 1) / static_cast<float>(count + 1)
+            });
+    return slots;
+}
+
+uint64_t Utils::getPassSlot(const Vulkan& vk, uint64_t count, uint64_t pass) {
+    if (!vk.variableCount)
+        return pass;
+    return count * (count - 1) / 2 + pass;
+}
@@ -25,8 +25,7 @@ void Buffer::construct(const Core::Device& device, const void* data, VkBufferUsa
         throw LSFG::vulkan_error(res, "Failed to create Vulkan buffer");
 
     // find memory type
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(device.getPhysicalDevice(), &memProps);
+    const auto& memProps = device.getMemoryProperties();
 
     VkMemoryRequirements memReqs;
     vkGetBufferMemoryRequirements(device.handle(), bufferHandle, &memReqs);
@@ -83,3 +82,13 @@ void Buffer::construct(const Core::Device& device, const void* data, VkBufferUsa
         }
     );
 }
+
+void Buffer::write(const Core::Device& device, const void* data, size_t offset, size_t size) {
+    uint8_t* buf{};
+    auto res = vkMapMemory(device.handle(), *this->memory, offset, size, 0,
+        reinterpret_cast<void**>(&buf));
+    if (res != VK_SUCCESS || buf == nullptr)
+        throw LSFG::vulkan_error(res, "Failed to map memory for Vulkan buffer");
+    std::copy_n(reinterpret_cast<const uint8_t*>(data), size, buf);
+    vkUnmapMemory(device.handle(), *this->memory);
+}
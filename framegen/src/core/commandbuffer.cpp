@@ -30,6 +30,7 @@ CommandBuffer::CommandBuffer(const Core::Device& device, const CommandPool& pool
 
     // store command buffer in shared ptr
     this->state = std::make_shared<CommandBufferState>(CommandBufferState::Empty);
+    this->usage = std::make_shared<VkCommandBufferUsageFlags>(0);
     this->commandBuffer = std::shared_ptr<VkCommandBuffer>(
         new VkCommandBuffer(commandBufferHandle),
         [dev = device.handle(), pool = pool.handle()](VkCommandBuffer* cmdBuffer) {
@@ -38,18 +39,19 @@ CommandBuffer::CommandBuffer(const Core::Device& device, const CommandPool& pool
     );
 }
 
-void CommandBuffer::begin() {
+void CommandBuffer::begin(VkCommandBufferUsageFlags usage) {
     if (*this->state != CommandBufferState::Empty)
         throw std::logic_error("Command buffer is not in Empty state");
 
     const VkCommandBufferBeginInfo beginInfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        .flags = usage
     };
     auto res = vkBeginCommandBuffer(*this->commandBuffer, &beginInfo);
     if (res != VK_SUCCESS)
         throw LSFG::vulkan_error(res, "Unable to begin command buffer");
 
+    *this->usage = usage;
     *this->state = CommandBufferState::Recording;
 }
 
@@ -120,5 +122,10 @@ void CommandBuffer::submit(VkQueue queue, std::optional<Fence> fence,
     if (res != VK_SUCCESS)
         throw LSFG::vulkan_error(res, "Unable to submit command buffer");
 
-    *this->state = CommandBufferState::Submitted;
+    this->markSubmitted();
+}
+
+void CommandBuffer::markSubmitted() {
+    if (*this->usage & VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+        *this->state = CommandBufferState::Submitted;
 }
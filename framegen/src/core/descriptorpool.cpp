@@ -10,18 +10,18 @@
 
 using namespace LSFG::Core;
 
-DescriptorPool::DescriptorPool(const Core::Device& device) {
+DescriptorPool::DescriptorPool(const Core::Device& device, uint32_t scale) {
     // create descriptor pool
     const std::array<VkDescriptorPoolSize, 4> pools{{ // arbitrary limits
-        { .type = VK_DESCRIPTOR_TYPE_SAMPLER, .descriptorCount = 4096 },
-        { .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, .descriptorCount = 4096 },
-        { .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = 4096 },
-        { .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 4096 }
+        { .type = VK_DESCRIPTOR_TYPE_SAMPLER, .descriptorCount = 4096 * scale },
+        { .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, .descriptorCount = 4096 * scale },
+        { .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = 4096 * scale },
+        { .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 4096 * scale }
     }};
     const VkDescriptorPoolCreateInfo desc{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
         .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
-        .maxSets = 16384,
+        .maxSets = 16384 * scale,
         .poolSizeCount = static_cast<uint32_t>(pools.size()),
         .pPoolSizes = pools.data()
     };
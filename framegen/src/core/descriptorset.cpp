@@ -12,6 +12,8 @@
 #include <vulkan/vulkan_core.h>
 
 #include <memory>
+#include <utility>
+#include <vector>
 #include <cstdint>
 
 using namespace LSFG::Core;
@@ -32,6 +34,8 @@ DescriptorSet::DescriptorSet(const Core::Device& device,
         throw LSFG::vulkan_error(res, "Unable to allocate descriptor set");
 
     /// store set in shared ptr
+    this->sampledImages = std::make_shared<std::vector<Image>>();
+    this->storageImages = std::make_shared<std::vector<Image>>();
     this->descriptorSet = std::shared_ptr<VkDescriptorSet>(
         new VkDescriptorSet(descriptorSetHandle),
         [dev = device.handle(), pool = pool](VkDescriptorSet* setHandle) {
@@ -54,6 +58,11 @@ void DescriptorSet::bind(const CommandBuffer& commandBuffer, const Pipeline& pip
 // updater class
 
 DescriptorSetUpdateBuilder& DescriptorSetUpdateBuilder::add(VkDescriptorType type, const Image& image) {
+    if (type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)
+        this->sampledImages.push_back(image);
+    else if (type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+        this->storageImages.push_back(image);
+
     this->entries.push_back({
         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
         .dstSet = this->descriptorSet->handle(),
@@ -118,6 +127,8 @@ void DescriptorSetUpdateBuilder::build() {
     vkUpdateDescriptorSets(this->device->handle(),
         static_cast<uint32_t>(this->entries.size()),
         this->entries.data(), 0, nullptr);
+    *this->descriptorSet->sampledImages = std::move(this->sampledImages);
+    *this->descriptorSet->storageImages = std::move(this->storageImages);
 
     // NOLINTBEGIN
     for (const auto& entry : this->entries) {
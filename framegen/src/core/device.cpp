@@ -4,6 +4,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -17,7 +18,8 @@ const std::vector<const char*> requiredExtensions = {
     "VK_EXT_robustness2",
 };
 
-Device::Device(const Instance& instance, uint64_t deviceUUID) {
+Device::Device(const Instance& instance, uint64_t deviceUUID, uint32_t queueCount,
+        bool priorityQueue) {
     // get all physical devices
     uint32_t deviceCount{};
     auto res = vkEnumeratePhysicalDevices(instance.handle(), &deviceCount, nullptr);
@@ -62,7 +64,13 @@ Device::Device(const Instance& instance, uint64_t deviceUUID) {
         throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED, "No compute queue family found");
 
     // create logical device
-    const float queuePriority{1.0F}; // highest priority
+    const uint32_t familyQueueCount = queueFamilies[*computeFamilyIdx].queueCount;
+    priorityQueue = priorityQueue && familyQueueCount > 1;
+    queueCount = std::clamp(queueCount, 1U, familyQueueCount - (priorityQueue ? 1 : 0));
+
+    std::vector<float> queuePriorities(queueCount, priorityQueue ? 0.5F : 1.0F);
+    if (priorityQueue)
+        queuePriorities.push_back(1.0F); // highest priority, created last
     VkPhysicalDeviceRobustness2FeaturesEXT robustness2{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT,
         .nullDescriptor = VK_TRUE,
@@ -81,8 +89,8 @@ Device::Device(const Instance& instance, uint64_t deviceUUID) {
     const VkDeviceQueueCreateInfo computeQueueDesc{
         .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
         .queueFamilyIndex = *computeFamilyIdx,
-        .queueCount = 1,
-        .pQueuePriorities = &queuePriority
+        .queueCount = static_cast<uint32_t>(queuePriorities.size()),
+        .pQueuePriorities = queuePriorities.data()
     };
     const VkDeviceCreateInfo deviceCreateInfo{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
@@ -97,14 +105,23 @@ Device::Device(const Instance& instance, uint64_t deviceUUID) {
     if (res != VK_SUCCESS | deviceHandle == VK_NULL_HANDLE)
         throw LSFG::vulkan_error(res, "Failed to create logical device");
 
-    // get compute queue
-    VkQueue queueHandle{};
-    vkGetDeviceQueue(deviceHandle, *computeFamilyIdx, 0, &queueHandle);
+    // get compute queues
+    for (uint32_t i = 0; i < queueCount; i++) {
+        VkQueue queueHandle{};
+        vkGetDeviceQueue(deviceHandle, *computeFamilyIdx, i, &queueHandle);
+        this->computeQueues.push_back(queueHandle);
+    }
+    if (priorityQueue) {
+        VkQueue queueHandle{};
+        vkGetDeviceQueue(deviceHandle, *computeFamilyIdx, queueCount, &queueHandle);
+        this->priorityQueue = queueHandle;
+    }
 
     // store in shared ptr
-    this->computeQueue = queueHandle;
     this->computeFamilyIdx = *computeFamilyIdx;
     this->physicalDevice = *physicalDevice;
+    vkGetPhysicalDeviceProperties(*physicalDevice, &this->properties);
+    vkGetPhysicalDeviceMemoryProperties(*physicalDevice, &this->memoryProperties);
     this->device = std::shared_ptr<VkDevice>(
         new VkDevice(deviceHandle),
         [](VkDevice* device) {
@@ -112,3 +129,14 @@ Device::Device(const Instance& instance, uint64_t deviceUUID) {
         }
     );
 }
+
+Device::Device(VkPhysicalDevice physicalDevice, VkDevice device,
+        uint32_t computeFamilyIdx, VkQueue queue,
+        const VkPhysicalDeviceProperties& properties,
+        const VkPhysicalDeviceMemoryProperties& memoryProperties)
+        : physicalDevice(physicalDevice),
+          properties(properties), memoryProperties(memoryProperties),
+          computeFamilyIdx(computeFamilyIdx), computeQueues{queue} {
+    // the device is owned by the caller
+    this->device = std::shared_ptr<VkDevice>(new VkDevice(device));
+}
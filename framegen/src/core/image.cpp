@@ -35,8 +35,7 @@ Image::Image(const Core::Device& device, VkExtent2D extent, VkFormat format,
         throw LSFG::vulkan_error(res, "Failed to create Vulkan image");
 
     // find memory type
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(device.getPhysicalDevice(), &memProps);
+    const auto& memProps = device.getMemoryProperties();
 
     VkMemoryRequirements memReqs;
     vkGetImageMemoryRequirements(device.handle(), imageHandle, &memReqs);
@@ -148,8 +147,7 @@ Image::Image(const Core::Device& device, VkExtent2D extent, VkFormat format,
         throw LSFG::vulkan_error(res, "Failed to create Vulkan image");
 
     // find memory type
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(device.getPhysicalDevice(), &memProps);
+    const auto& memProps = device.getMemoryProperties();
 
     VkMemoryRequirements memReqs;
     vkGetImageMemoryRequirements(device.handle(), imageHandle, &memReqs);
@@ -239,3 +237,44 @@ Image::Image(const Core::Device& device, VkExtent2D extent, VkFormat format,
         }
     );
 }
+
+// borrowed image constructor
+
+Image::Image(const Core::Device& device, VkImage image, VkExtent2D extent,
+        VkFormat format, VkImageAspectFlags aspectFlags)
+        : extent(extent), format(format), aspectFlags(aspectFlags) {
+    // create image view
+    const VkImageViewCreateInfo viewDesc{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = format,
+        .components = {
+            .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .a = VK_COMPONENT_SWIZZLE_IDENTITY
+        },
+        .subresourceRange = {
+            .aspectMask = aspectFlags,
+            .levelCount = 1,
+            .layerCount = 1
+        }
+    };
+
+    VkImageView viewHandle{};
+    auto res = vkCreateImageView(device.handle(), &viewDesc, nullptr, &viewHandle);
+    if (res != VK_SUCCESS || viewHandle == VK_NULL_HANDLE)
+        throw LSFG::vulkan_error(res, "Failed to create image view");
+
+    // store objects in shared ptr, the image and its memory belong to the caller
+    this->layout = std::make_shared<VkImageLayout>(VK_IMAGE_LAYOUT_UNDEFINED);
+    this->image = std::make_shared<VkImage>(image);
+    this->memory = std::make_shared<VkDeviceMemory>(VK_NULL_HANDLE);
+    this->view = std::shared_ptr<VkImageView>(
+        new VkImageView(viewHandle),
+        [dev = device.handle()](VkImageView* imgView) {
+            vkDestroyImageView(dev, *imgView, nullptr);
+        }
+    );
+}
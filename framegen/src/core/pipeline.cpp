@@ -1,12 +1,19 @@
 #include "core/pipeline.hpp"
 #include "core/device.hpp"
+#include "core/pipelinecache.hpp"
 #include "core/shadermodule.hpp"
 #include "core/commandbuffer.hpp"
 #include "common/exception.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <memory>
+#include <thread>
+#include <vector>
 
 using namespace LSFG::Core;
 
@@ -23,25 +30,7 @@ Pipeline::Pipeline(const Core::Device& device, const ShaderModule& shader) {
     if (res != VK_SUCCESS || !layoutHandle)
         throw LSFG::vulkan_error(res, "Failed to create pipeline layout");
 
-    // create pipeline
-    const VkPipelineShaderStageCreateInfo shaderStageInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-        .stage = VK_SHADER_STAGE_COMPUTE_BIT,
-        .module = shader.handle(),
-        .pName = "main",
-    };
-    const VkComputePipelineCreateInfo pipelineDesc{
-        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-        .stage = shaderStageInfo,
-        .layout = layoutHandle,
-    };
-    VkPipeline pipelineHandle{};
-    res = vkCreateComputePipelines(device.handle(),
-        VK_NULL_HANDLE, 1, &pipelineDesc, nullptr, &pipelineHandle);
-    if (res != VK_SUCCESS || !pipelineHandle)
-        throw LSFG::vulkan_error(res, "Failed to create compute pipeline");
-
-    // store layout and pipeline in shared ptr
+    // store layout and (not yet compiled) pipeline in shared ptr
     this->layout = std::shared_ptr<VkPipelineLayout>(
         new VkPipelineLayout(layoutHandle),
         [dev = device.handle()](VkPipelineLayout* layout) {
@@ -49,13 +38,67 @@ Pipeline::Pipeline(const Core::Device& device, const ShaderModule& shader) {
         }
     );
     this->pipeline = std::shared_ptr<VkPipeline>(
-        new VkPipeline(pipelineHandle),
+        new VkPipeline(VK_NULL_HANDLE),
         [dev = device.handle()](VkPipeline* pipeline) {
             vkDestroyPipeline(dev, *pipeline, nullptr);
         }
     );
 }
 
+void Pipeline::compile(const Core::Device& device,
+        const std::vector<std::pair<Pipeline, ShaderModule>>& pipelines,
+        const PipelineCache& cache) {
+    if (pipelines.empty())
+        return;
+
+    // describe all pipelines
+    std::vector<VkComputePipelineCreateInfo> pipelineDescs;
+    pipelineDescs.reserve(pipelines.size());
+    for (const auto& [pipeline, shader] : pipelines)
+        pipelineDescs.emplace_back(VkComputePipelineCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .stage = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                .module = shader.handle(),
+                .pName = "main",
+            },
+            .layout = pipeline.getLayout(),
+        });
+
+    // compile the pipelines in chunks across worker threads
+    const size_t workerCount = std::clamp<size_t>(
+        std::thread::hardware_concurrency(), 1, pipelines.size());
+    const size_t chunkSize = (pipelines.size() + workerCount - 1) / workerCount;
+
+    std::vector<VkPipeline> pipelineHandles(pipelines.size());
+    std::vector<VkResult> results(workerCount, VK_SUCCESS);
+    auto worker = [&](size_t chunk) {
+        const size_t first = chunk * chunkSize;
+        const size_t count = std::min(chunkSize, pipelines.size() - first);
+        results.at(chunk) = vkCreateComputePipelines(device.handle(), cache.handle(),
+            static_cast<uint32_t>(count), &pipelineDescs.at(first), nullptr,
+            &pipelineHandles.at(first));
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t chunk = 1; chunk * chunkSize < pipelines.size(); chunk++)
+        workers.emplace_back(worker, chunk);
+    worker(0);
+    for (auto& thread : workers)
+        thread.join();
+
+    // store the compiled pipelines, even partially failed batches must be cleaned up
+    for (size_t i = 0; i < pipelines.size(); i++)
+        *pipelines.at(i).first.pipeline = pipelineHandles.at(i);
+
+    for (const auto res : results)
+        if (res != VK_SUCCESS)
+            throw LSFG::vulkan_error(res, "Failed to create compute pipelines");
+    if (std::ranges::find(pipelineHandles, VK_NULL_HANDLE) != pipelineHandles.end())
+        throw LSFG::vulkan_error(VK_ERROR_UNKNOWN, "Failed to create compute pipelines");
+}
+
 void Pipeline::bind(const CommandBuffer& commandBuffer) const {
      vkCmdBindPipeline(commandBuffer.handle(), VK_PIPELINE_BIND_POINT_COMPUTE, *this->pipeline);
 }
@@ -0,0 +1,122 @@
+#include "core/pipelinecache.hpp"
+#include "core/device.hpp"
+#include "common/exception.hpp"
+
+#include <vulkan/vulkan_core.h>
+#include <unistd.h>
+
+#include <system_error>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ios>
+
+using namespace LSFG::Core;
+
+namespace {
+    /// Read a cache file, returning no data if it does not belong to the device.
+    std::vector<uint8_t> readCacheFile(const VkPhysicalDeviceProperties& properties,
+            const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return {};
+
+        const std::streamsize size = file.tellg();
+        if (size < static_cast<std::streamsize>(sizeof(VkPipelineCacheHeaderVersionOne)))
+            return {};
+
+        std::vector<uint8_t> data(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char*>(data.data()), size))
+            return {};
+
+        // validate the header against the device
+        VkPipelineCacheHeaderVersionOne header{};
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (header.headerSize < sizeof(header)
+                || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+                || header.vendorID != properties.vendorID
+                || header.deviceID != properties.deviceID
+                || !std::equal(
+                        std::begin(header.pipelineCacheUUID), std::end(header.pipelineCacheUUID),
+                        std::begin(properties.pipelineCacheUUID)))
+            return {};
+        return data;
+    }
+}
+
+PipelineCache::PipelineCache(const Core::Device& device, const std::string& path) {
+    std::vector<uint8_t> data;
+    if (!path.empty())
+        data = readCacheFile(device.getProperties(), path);
+
+    // create pipeline cache
+    const VkPipelineCacheCreateInfo desc{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = data.size(),
+        .pInitialData = data.empty() ? nullptr : data.data()
+    };
+    VkPipelineCache pipelineCacheHandle{};
+    auto res = vkCreatePipelineCache(device.handle(), &desc, nullptr, &pipelineCacheHandle);
+    if (res != VK_SUCCESS || pipelineCacheHandle == VK_NULL_HANDLE)
+        throw LSFG::vulkan_error(res, "Unable to create pipeline cache");
+
+    // store pipeline cache in shared ptr
+    this->pipelineCache = std::shared_ptr<VkPipelineCache>(
+        new VkPipelineCache(pipelineCacheHandle),
+        [dev = device.handle()](VkPipelineCache* pipelineCacheHandle) {
+            vkDestroyPipelineCache(dev, *pipelineCacheHandle, nullptr);
+        }
+    );
+}
+
+void PipelineCache::save(const Core::Device& device, const std::string& path) const {
+    // retrieve the cache data
+    size_t size{};
+    auto res = vkGetPipelineCacheData(device.handle(), this->handle(), &size, nullptr);
+    if (res != VK_SUCCESS)
+        throw LSFG::vulkan_error(res, "Unable to get pipeline cache size");
+
+    std::vector<uint8_t> data(size);
+    res = vkGetPipelineCacheData(device.handle(), this->handle(), &size, data.data());
+    if (res != VK_SUCCESS)
+        throw LSFG::vulkan_error(res, "Unable to get pipeline cache data");
+    data.resize(size);
+
+    // write to a temporary file, then move it in place
+    const std::filesystem::path target(path);
+    std::filesystem::create_directories(target.parent_path());
+
+    std::filesystem::path tmp = target;
+    tmp += ".tmp" + std::to_string(getpid());
+    std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to open pipeline cache: " + tmp.string());
+    file.write(reinterpret_cast<const char*>(data.data()),
+        static_cast<std::streamsize>(data.size()));
+    file.close();
+    if (!file.good()) {
+        const int error = errno;
+        std::error_code ec;
+        std::filesystem::remove(tmp, ec);
+        throw std::system_error(error, std::generic_category(),
+            "Failed to write pipeline cache: " + tmp.string());
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, target, ec);
+    if (ec) {
+        std::error_code removeEc;
+        std::filesystem::remove(tmp, removeEc);
+        throw std::filesystem::filesystem_error("Failed to move pipeline cache in place",
+            tmp, target, ec);
+    }
+}
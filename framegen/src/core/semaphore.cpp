@@ -37,10 +37,15 @@ Semaphore::Semaphore(const Core::Device& device, std::optional<uint32_t> initial
     );
 }
 
-Semaphore::Semaphore(const Core::Device& device, int fd) {
+Semaphore::Semaphore(const Core::Device& device, int fd, bool timeline) {
     // create semaphore
+    const VkSemaphoreTypeCreateInfo typeInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE
+    };
     const VkExportSemaphoreCreateInfo exportInfo{
         .sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO,
+        .pNext = timeline ? &typeInfo : nullptr,
         .handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT
     };
     const VkSemaphoreCreateInfo desc{
@@ -67,7 +72,7 @@ Semaphore::Semaphore(const Core::Device& device, int fd) {
         throw LSFG::vulkan_error(res, "Unable to import semaphore from fd");
 
     // store semaphore in shared ptr
-    this->isTimeline = false;
+    this->isTimeline = timeline;
     this->semaphore = std::shared_ptr<VkSemaphore>(
         new VkSemaphore(semaphoreHandle),
         [dev = device.handle()](VkSemaphore* semaphoreHandle) {
@@ -76,6 +81,9 @@ Semaphore::Semaphore(const Core::Device& device, int fd) {
     );
 }
 
+Semaphore::Semaphore(const Core::Device&, VkSemaphore semaphore, bool timeline)
+        : semaphore(std::make_shared<VkSemaphore>(semaphore)), isTimeline(timeline) {}
+
 void Semaphore::signal(const Core::Device& device, uint64_t value) const {
     if (!this->isTimeline)
         throw std::logic_error("Invalid timeline semaphore");
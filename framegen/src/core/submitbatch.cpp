@@ -0,0 +1,100 @@
+#include "core/submitbatch.hpp"
+#include "core/commandbuffer.hpp"
+#include "core/semaphore.hpp"
+#include "common/exception.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+using namespace LSFG::Core;
+
+SubmitBatch& SubmitBatch::add(const CommandBuffer& buffer) {
+    if (buffer.getState() != CommandBufferState::Full)
+        throw std::logic_error("Command buffer is not in Full state");
+
+    this->add();
+    this->buffers.push_back(buffer);
+    this->bufferInfos.push_back({
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+        .commandBuffer = buffer.handle()
+    });
+    this->entries.back().bufferCount++;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::add() {
+    this->entries.push_back({
+        .bufferOffset = this->bufferInfos.size(),
+        .bufferCount = 0,
+        .waitOffset = this->waits.size(),
+        .waitCount = 0,
+        .signalOffset = this->signals.size(),
+        .signalCount = 0
+    });
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::wait(const Semaphore& semaphore, uint64_t value,
+        VkPipelineStageFlags2 stage) {
+    if (this->entries.empty())
+        throw std::logic_error("No submission to wait with");
+
+    this->waits.push_back({
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = semaphore.handle(),
+        .value = value,
+        .stageMask = stage
+    });
+    this->entries.back().waitCount++;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::signal(const Semaphore& semaphore, uint64_t value,
+        VkPipelineStageFlags2 stage) {
+    if (this->entries.empty())
+        throw std::logic_error("No submission to signal with");
+
+    this->signals.push_back({
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = semaphore.handle(),
+        .value = value,
+        .stageMask = stage
+    });
+    this->entries.back().signalCount++;
+    return *this;
+}
+
+void SubmitBatch::submit(VkQueue queue) {
+    // build submit infos now, as the storage may have moved while collecting
+    this->submitInfos.clear();
+    for (const auto& entry : this->entries) {
+        this->submitInfos.push_back({
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .waitSemaphoreInfoCount = static_cast<uint32_t>(entry.waitCount),
+            .pWaitSemaphoreInfos = this->waits.data() + entry.waitOffset,
+            .commandBufferInfoCount = static_cast<uint32_t>(entry.bufferCount),
+            .pCommandBufferInfos = this->bufferInfos.data() + entry.bufferOffset,
+            .signalSemaphoreInfoCount = static_cast<uint32_t>(entry.signalCount),
+            .pSignalSemaphoreInfos = this->signals.data() + entry.signalOffset
+        });
+    }
+
+    if (!this->submitInfos.empty()) {
+        auto res = vkQueueSubmit2(queue, static_cast<uint32_t>(this->submitInfos.size()),
+            this->submitInfos.data(), VK_NULL_HANDLE);
+        if (res != VK_SUCCESS)
+            throw LSFG::vulkan_error(res, "Unable to submit command buffers");
+    }
+
+    for (auto& buffer : this->buffers)
+        buffer.markSubmitted();
+
+    this->buffers.clear();
+    this->bufferInfos.clear();
+    this->waits.clear();
+    this->signals.clear();
+    this->entries.clear();
+}
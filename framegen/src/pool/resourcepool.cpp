@@ -6,6 +6,7 @@
 #include <vulkan/vulkan_core.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 using namespace LSFG;
@@ -22,10 +23,11 @@ struct ConstantBuffer {
     float uiThreshold;
     std::array<uint32_t, 3> pad;
 };
+static_assert(offsetof(ConstantBuffer, timestamp) == ResourcePool::TIMESTAMP_OFFSET);
 
 Core::Buffer ResourcePool::getBuffer(
             const Core::Device& device,
-            float timestamp, bool firstIter, bool firstIterS) {
+            float timestamp, bool firstIter, bool firstIterS, bool unique) {
     uint64_t hash = 0;
     const union { float f; uint32_t i; } u{
         .f = timestamp };
@@ -34,7 +36,7 @@ Core::Buffer ResourcePool::getBuffer(
     hash |= static_cast<uint64_t>(firstIterS) << 33;
 
     auto it = buffers.find(hash);
-    if (it != buffers.end())
+    if (!unique && it != buffers.end())
         return it->second;
 
     // create the buffer
@@ -46,6 +48,10 @@ Core::Buffer ResourcePool::getBuffer(
         .timestamp = timestamp,
         .uiThreshold = 0.5F,
     };
+    if (unique)
+        return Core::Buffer(device, data,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
     Core::Buffer buffer(device, data, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
     buffers[hash] = buffer;
     return buffer;
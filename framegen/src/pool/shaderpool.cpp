@@ -6,7 +6,9 @@
 #include <vulkan/vulkan_core.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include <unordered_map>
 #include <string>
 #include <vector>
 #include <utility>
@@ -14,35 +16,83 @@
 using namespace LSFG;
 using namespace LSFG::Pool;
 
+namespace {
+    /// Hash the shader bytecode together with its descriptor types.
+    uint64_t hashShader(const std::vector<uint8_t>& bytecode,
+            const std::vector<std::pair<size_t, VkDescriptorType>>& types) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        auto mix = [&hash](uint64_t value) {
+            hash ^= value;
+            hash *= 0x100000001B3ULL;
+        };
+        for (const uint8_t byte : bytecode)
+            mix(byte);
+        for (const auto& [count, type] : types) {
+            mix(count);
+            mix(static_cast<uint64_t>(type));
+        }
+        return hash;
+    }
+}
+
 Core::ShaderModule ShaderPool::getShader(
         const Core::Device& device, const std::string& name,
         const std::vector<std::pair<size_t, VkDescriptorType>>& types) {
-    auto it = shaders.find(name);
-    if (it != shaders.end())
-        return it->second;
+    auto kit = keys.find(name);
+    if (kit != keys.end())
+        return shaders.at(kit->second).module;
 
     // grab the shader
     auto bytecode = this->source(name);
     if (bytecode.empty())
         throw std::runtime_error("Shader code is empty: " + name);
 
+    // reuse an identical shader module if one exists, probing past colliding hashes
+    uint64_t key = hashShader(bytecode, types);
+    for (auto it = shaders.find(key); it != shaders.end(); it = shaders.find(++key)) {
+        if (it->second.bytecode == bytecode && it->second.types == types) {
+            keys[name] = key;
+            return it->second.module;
+        }
+    }
+
     // create the shader module
     Core::ShaderModule shader(device, bytecode, types);
-    shaders[name] = shader;
+    shaders.emplace(key, ShaderEntry{ shader, std::move(bytecode), types });
+    keys[name] = key;
     return shader;
 }
 
 Core::Pipeline ShaderPool::getPipeline(
         const Core::Device& device, const std::string& name) {
-    auto it = pipelines.find(name);
-    if (it != pipelines.end())
-        return it->second;
-
     // grab the shader module
     auto shader = this->getShader(device, name, {});
+    const uint64_t key = keys.at(name);
 
-    // create the pipeline
+    auto it = pipelines.find(key);
+    if (it != pipelines.end())
+        return it->second;
+
+    // create the pipeline, compilation is deferred to the next batch
     Core::Pipeline pipeline(device, shader);
-    pipelines[name] = pipeline;
+    pipelines[key] = pipeline;
+    this->pendingPipelines.emplace_back(pipeline, shader);
     return pipeline;
 }
+
+void ShaderPool::createPipelines(const Core::Device& device) {
+    if (this->pendingPipelines.empty())
+        return;
+
+    auto pending = std::exchange(this->pendingPipelines, {});
+    try {
+        Core::Pipeline::compile(device, pending, this->cache);
+    } catch (...) {
+        // forget pipelines that failed to compile, so they are retried next time
+        std::erase_if(this->pipelines, [](const auto& entry) {
+            return entry.second.handle() == VK_NULL_HANDLE;
+        });
+        throw;
+    }
+    this->dirty = true;
+}
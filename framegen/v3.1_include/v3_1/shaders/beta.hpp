@@ -1,13 +1,13 @@
 #pragma once
 
 #include "core/buffer.hpp"
-#include "core/commandbuffer.hpp"
 #include "core/descriptorset.hpp"
 #include "core/image.hpp"
 #include "core/pipeline.hpp"
 #include "core/sampler.hpp"
 #include "core/shadermodule.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 
 #include <array>
 #include <cstdint>
@@ -35,9 +35,11 @@ namespace LSFG_3_1::Shaders {
         ///
         /// Dispatch the shaderchain.
         ///
-        void Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount);
+        /// @param graph Frame graph to add the dispatches to
+        ///
+        void Dispatch(Utils::FrameGraph& graph, uint64_t frameCount);
 
-        /// Get the output images
+        /// Get the output images, two sets corresponding to a frame count % 2.
         [[nodiscard]] const auto& getOutImages() const { return this->outImgs; }
 
         /// Trivially copyable, moveable and destructible
@@ -52,12 +54,13 @@ namespace LSFG_3_1::Shaders {
         std::array<Core::Sampler, 2> samplers;
         Core::Buffer buffer;
         std::array<Core::DescriptorSet, 3> firstDescriptorSet;
-        std::array<Core::DescriptorSet, 4> descriptorSets;
+        std::array<Core::DescriptorSet, 3> descriptorSets;
+        std::array<Core::DescriptorSet, 2> lastDescriptorSet;
 
         std::array<std::array<Core::Image, 4>, 3> inImgs;
         std::array<Core::Image, 2> tempImgs1;
         std::array<Core::Image, 2> tempImgs2;
-        std::array<Core::Image, 6> outImgs;
+        std::array<std::array<Core::Image, 6>, 2> outImgs;
     };
 
 }
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "core/buffer.hpp"
-#include "core/commandbuffer.hpp"
 #include "core/descriptorset.hpp"
 #include "core/image.hpp"
 #include "core/pipeline.hpp"
 #include "core/sampler.hpp"
 #include "core/shadermodule.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 
 #include <array>
 #include <cstdint>
@@ -36,7 +36,9 @@ namespace LSFG_3_1::Shaders {
         ///
         /// Dispatch the shaderchain.
         ///
-        void Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount);
+        /// @param graph Frame graph to add the dispatches to
+        ///
+        void Dispatch(Utils::FrameGraph& graph, uint64_t frameCount);
 
         /// Get the output images.
         [[nodiscard]] const auto& getOutImages() const { return this->outImgs; }
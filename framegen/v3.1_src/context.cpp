@@ -1,121 +1,257 @@
 #include "v3_1/context.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 #include "common/exception.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <stdexcept>
 #include <vector>
 #include <cstddef>
 #include <algorithm>
 #include <optional>
+#include <utility>
 #include <cstdint>
+#include <array>
 
 using namespace LSFG_3_1;
 
 Context::Context(Vulkan& vk,
-        int in0, int in1, const std::vector<int>& outN,
-        VkExtent2D extent, VkFormat format) {
-    // import input images
-    this->inImg_0 = Core::Image(vk.device, extent, format,
-        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_IMAGE_ASPECT_COLOR_BIT, in0);
-    this->inImg_1 = Core::Image(vk.device, extent, format,
-        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_IMAGE_ASPECT_COLOR_BIT, in1);
-
-    // prepare render data
-    for (size_t i = 0; i < 8; i++) {
-        auto& data = this->data.at(i);
-        data.internalSemaphores.resize(vk.generationCount);
-        data.outSemaphores.resize(vk.generationCount);
-        data.completionFences.resize(vk.generationCount);
-        data.cmdBuffers2.resize(vk.generationCount);
-    }
+        Core::Image in0, Core::Image in1, const std::vector<Core::Image>& outN,
+        VkFormat format,
+        std::optional<Core::Semaphore> inSem, std::optional<Core::Semaphore> outSem)
+        : inImg_0(std::move(in0)), inImg_1(std::move(in1)),
+          inSemaphore(std::move(inSem)) {
+    // create missing timeline semaphores
+    this->internalSemaphore = Core::Semaphore(vk.device, std::optional<uint32_t>(0));
+    this->outSemaphore = outSem.has_value()
+        ? *outSem
+        : Core::Semaphore(vk.device, std::optional<uint32_t>(0));
 
-    // create shader chains
+    // create shader chains, with a set of generation chains per lane
     this->mipmaps = Shaders::Mipmaps(vk, this->inImg_0, this->inImg_1);
     for (size_t i = 0; i < 7; i++)
         this->alpha.at(i) = Shaders::Alpha(vk, this->mipmaps.getOutImages().at(i));
     this->beta = Shaders::Beta(vk, this->alpha.at(0).getOutImages());
-    for (size_t i = 0; i < 7; i++) {
-        this->gamma.at(i) = Shaders::Gamma(vk,
-            this->alpha.at(6 - i).getOutImages(),
-            this->beta.getOutImages().at(std::min<size_t>(6 - i, 5)),
-            (i == 0) ? std::nullopt : std::make_optional(this->gamma.at(i - 1).getOutImage()));
-        if (i < 4) continue;
-
-        this->delta.at(i - 4) = Shaders::Delta(vk,
-            this->alpha.at(6 - i).getOutImages(),
-            this->beta.getOutImages().at(6 - i),
-            (i == 4) ? std::nullopt : std::make_optional(this->gamma.at(i - 1).getOutImage()),
-            (i == 4) ? std::nullopt : std::make_optional(this->delta.at(i - 5).getOutImage1()),
-            (i == 4) ? std::nullopt : std::make_optional(this->delta.at(i - 5).getOutImage2()));
+    const auto betaOut = [this](size_t level) { // both parities of a beta output
+        return std::array<Core::Image, 2>{
+            this->beta.getOutImages().at(0).at(level),
+            this->beta.getOutImages().at(1).at(level)
+        };
+    };
+    for (size_t l = 0; l < vk.laneCount; l++) {
+        auto& lane = this->lanes.emplace_back();
+        for (size_t i = 0; i < 7; i++) {
+            lane.gamma.at(i) = Shaders::Gamma(vk,
+                this->alpha.at(6 - i).getOutImages(),
+                betaOut(std::min<size_t>(6 - i, 5)),
+                (i == 0) ? std::nullopt : std::make_optional(lane.gamma.at(i - 1).getOutImage()),
+                l);
+            if (i < 4) continue;
+
+            lane.delta.at(i - 4) = Shaders::Delta(vk,
+                this->alpha.at(6 - i).getOutImages(),
+                betaOut(6 - i),
+                (i == 4) ? std::nullopt : std::make_optional(lane.gamma.at(i - 1).getOutImage()),
+                (i == 4) ? std::nullopt : std::make_optional(lane.delta.at(i - 5).getOutImage1()),
+                (i == 4) ? std::nullopt : std::make_optional(lane.delta.at(i - 5).getOutImage2()),
+                l);
+        }
+        lane.generate = Shaders::Generate(vk,
+            this->inImg_0, this->inImg_1,
+            lane.gamma.at(6).getOutImage(),
+            lane.delta.at(2).getOutImage1(),
+            lane.delta.at(2).getOutImage2(),
+            outN, format, l);
+        lane.semaphore = vk.laneCount > 1
+            ? Core::Semaphore(vk.device, std::optional<uint32_t>(0))
+            : this->outSemaphore;
     }
-    this->generate = Shaders::Generate(vk,
-        this->inImg_0, this->inImg_1,
-        this->gamma.at(6).getOutImage(),
-        this->delta.at(2).getOutImage1(),
-        this->delta.at(2).getOutImage2(),
-        outN, format);
-}
 
-void Context::present(Vulkan& vk,
-        int inSem, const std::vector<int>& outSem) {
-    auto& data = this->data.at(this->frameIdx % 8);
+    // start every variant out with evenly spaced timestamps
+    const auto slots = Utils::getPassSlots(vk);
+    this->slotCount = slots.size();
+    if (vk.dynamicTimestamps) {
+        std::vector<float> timestamps;
+        for (size_t variant = 0; variant < 6; variant++)
+            for (const auto& slot : slots)
+                timestamps.push_back(slot.timestamp);
+        this->timestamps = Core::Buffer(vk.device, timestamps.data(),
+            timestamps.size() * sizeof(float), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    }
 
-    // 3. wait for completion of previous frame in this slot
-    if (data.shouldWait)
-        for (auto& fence : data.completionFences)
-            if (!fence.wait(vk.device, UINT64_MAX))
-                throw LSFG::vulkan_error(VK_TIMEOUT, "Fence wait timed out");
-    data.shouldWait = true;
+    // compile all pipelines requested by the shader chains at once
+    vk.shaders.createPipelines(vk.device);
+}
 
+void Context::record(Vulkan& vk, RenderData& data, uint64_t frameCount,
+        VkCommandBufferUsageFlags usage, bool everyCount) {
     // 1. create mipmaps and process input image
-    if (inSem >= 0) data.inSemaphore = Core::Semaphore(vk.device, inSem);
-    for (size_t i = 0; i < vk.generationCount; i++)
-        data.internalSemaphores.at(i) = Core::Semaphore(vk.device);
-
     data.cmdBuffer1 = Core::CommandBuffer(vk.device, vk.commandPool);
-    data.cmdBuffer1.begin();
+    data.cmdBuffer1.begin(usage);
 
-    this->mipmaps.Dispatch(data.cmdBuffer1, this->frameIdx);
+    Utils::FrameGraph graph1(data.cmdBuffer1);
+    this->mipmaps.Dispatch(graph1, frameCount);
     for (size_t i = 0; i < 7; i++)
-        this->alpha.at(6 - i).Dispatch(data.cmdBuffer1, this->frameIdx);
-    this->beta.Dispatch(data.cmdBuffer1, this->frameIdx);
+        this->alpha.at(6 - i).Dispatch(graph1, frameCount);
+    this->beta.Dispatch(graph1, frameCount);
+    this->barrierCount = graph1.build();
 
     data.cmdBuffer1.end();
-    std::vector<Core::Semaphore> waits = { data.inSemaphore };
-    if (inSem < 0) waits.clear();
-    data.cmdBuffer1.submit(vk.device.getComputeQueue(), std::nullopt,
-        waits, std::nullopt,
-        data.internalSemaphores, std::nullopt);
 
     // 2. generate intermediary frames
-    for (size_t pass = 0; pass < vk.generationCount; pass++) {
-        auto& internalSemaphore = data.internalSemaphores.at(pass);
-        auto& outSemaphore = data.outSemaphores.at(pass);
-        if (inSem >= 0) outSemaphore = Core::Semaphore(vk.device, outSem.empty() ? -1 : outSem.at(pass));
-        auto& completionFence = data.completionFences.at(pass);
-        completionFence = Core::Fence(vk.device);
-
-        auto& buf2 = data.cmdBuffers2.at(pass);
+    const auto slots = Utils::getPassSlots(vk);
+    data.cmdBuffers2.clear();
+    data.cmdBuffers2.resize(slots.size());
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        const bool full = slots.at(slot).count == vk.generationCount;
+        if (!everyCount && !full)
+            continue;
+
+        auto& buf2 = data.cmdBuffers2.at(slot);
         buf2 = Core::CommandBuffer(vk.device, vk.commandPool);
-        buf2.begin();
+        buf2.begin(usage);
+
+        auto& lane = this->lanes.at(slots.at(slot).pass % this->lanes.size());
+        size_t barriers = 0;
+        if (vk.dynamicTimestamps) {
+            std::vector<Core::Buffer> buffers;
+            for (const auto& gamma : lane.gamma)
+                buffers.push_back(gamma.getBuffer(slot));
+            for (const auto& delta : lane.delta)
+                buffers.push_back(delta.getBuffer(slot));
+            buffers.push_back(lane.generate.getBuffer(slot));
+            barriers += Utils::copyTimestamp(buf2, this->timestamps,
+                (frameCount * this->slotCount + slot) * sizeof(float), buffers);
+        }
 
+        Utils::FrameGraph graph2(buf2);
         for (size_t i = 0; i < 7; i++) {
-            this->gamma.at(i).Dispatch(buf2, this->frameIdx, pass);
+            lane.gamma.at(i).Dispatch(graph2, frameCount, slot);
             if (i >= 4)
-                this->delta.at(i - 4).Dispatch(buf2, this->frameIdx, pass);
+                lane.delta.at(i - 4).Dispatch(graph2, frameCount, slot);
         }
-        this->generate.Dispatch(buf2, this->frameIdx, pass);
+        lane.generate.Dispatch(graph2, frameCount, slot);
+        barriers += graph2.build();
+        if (full) // count the barriers of a frame running every pass
+            this->barrierCount += barriers;
 
         buf2.end();
-        std::vector<Core::Semaphore> signals = { outSemaphore };
-        if (inSem < 0) signals.clear();
-        buf2.submit(vk.device.getComputeQueue(), completionFence,
-            { internalSemaphore }, std::nullopt,
-            signals, std::nullopt);
     }
+}
+
+uint64_t Context::present(Vulkan& vk, uint64_t count, const std::vector<float>& timestamps) {
+    if (count > vk.generationCount || (!vk.variableCount && count != vk.generationCount))
+        throw std::logic_error("Invalid generation pass count");
+
+    // wait for completion of the frame 8 frames ago
+    if (this->frameIdx >= 8) {
+        const uint64_t value = (this->frameIdx - 8 + 1) * vk.generationCount;
+        if (!this->outSemaphore.wait(vk.device, value))
+            throw LSFG::vulkan_error(VK_TIMEOUT, "Semaphore wait timed out");
+    }
+
+    // images start out undefined, so the first frames are recorded as they come, running
+    // every pass. once every image has been transitioned, each of the 6 variants is
+    // recorded for reuse, for every pass count if it may vary.
+    if (this->frameIdx < 6) {
+        count = vk.generationCount;
+        this->record(vk, this->data.at(this->frameIdx), this->frameIdx,
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, false);
+    } else if (this->frameIdx == 6) {
+        if (!this->outSemaphore.wait(vk.device, 6 * vk.generationCount))
+            throw LSFG::vulkan_error(VK_TIMEOUT, "Semaphore wait timed out");
+        for (uint64_t variant = 0; variant < 6; variant++)
+            this->record(vk, this->data.at(variant), variant,
+                VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT, true);
+    }
+    auto& data = this->data.at(this->frameIdx % 6);
+
+    // overwrite the timestamps of this variant once the frame that last copied them is done
+    if (vk.dynamicTimestamps && count > 0) {
+        if (this->frameIdx >= 6) {
+            const uint64_t value = (this->frameIdx - 6 + 1) * vk.generationCount;
+            if (!this->outSemaphore.wait(vk.device, value))
+                throw LSFG::vulkan_error(VK_TIMEOUT, "Semaphore wait timed out");
+        }
+
+        std::vector<float> even;
+        const std::vector<float>* values = &timestamps;
+        if (timestamps.size() != count) {
+            for (uint64_t pass = 0; pass < count; pass++)
+                even.push_back(static_cast<float>(pass + 1) / static_cast<float>(count + 1));
+            values = &even;
+        }
+        const uint64_t slot = (this->frameIdx % 6) * this->slotCount
+            + Utils::getPassSlot(vk, count, 0);
+        this->timestamps.write(vk.device, values->data(),
+            slot * sizeof(float), count * sizeof(float));
+    }
+
+    // submit the first step, in pipelined mode ahead of any queued generation work
+    auto& mainBatch = this->lanes.front().batch;
+    auto& firstBatch = vk.pipelined ? this->analysisBatch : mainBatch;
+    firstBatch.add(data.cmdBuffer1);
+    if (this->inSemaphore.has_value())
+        firstBatch.wait(*this->inSemaphore, this->frameIdx + 1);
+    // alpha and beta outputs are overwritten two frames later, possibly while generation
+    // of the frame before still reads them on another lane or behind the priority queue
+    if (this->frameIdx >= 2)
+        firstBatch.wait(this->outSemaphore, (this->frameIdx - 1) * vk.generationCount);
+    firstBatch.signal(this->internalSemaphore, this->frameIdx + 1);
+    if (vk.pipelined)
+        this->analysisBatch.submit(*vk.device.getPriorityQueue());
+
+    // then each generation pass to its lane. the last pass completes the frame, even if
+    // fewer passes run, so that waits for whole frames do not depend on the pass count.
+    const auto passValue = [&vk, count, frameIdx = this->frameIdx](uint64_t pass) {
+        return pass + 1 == count
+            ? (frameIdx + 1) * vk.generationCount
+            : frameIdx * vk.generationCount + pass + 1;
+    };
+    for (size_t pass = 0; pass < count; pass++) {
+        auto& lane = this->lanes.at(pass % this->lanes.size());
+        lane.batch.add(data.cmdBuffers2.at(Utils::getPassSlot(vk, count, pass)))
+            .wait(this->internalSemaphore, this->frameIdx + 1)
+            .signal(lane.semaphore, passValue(pass));
+    }
+    const uint64_t frameStart = this->frameIdx * vk.generationCount;
+    if (count == 0) { // nothing to generate, complete the frame once it is analyzed
+        mainBatch.add()
+            .wait(this->internalSemaphore, this->frameIdx + 1,
+                VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+            .signal(this->outSemaphore, frameStart + vk.generationCount,
+                VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        if (this->lanes.size() > 1 && frameStart > 0) // other lanes may still be forwarding
+            mainBatch.wait(this->outSemaphore, frameStart, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    }
+
+    // lanes finish out of order, but output values have to be signaled in order. each lane
+    // forwards its passes once the pass before is forwarded, after all of its own work so
+    // that no lane's queue holds generation back for another lane.
+    if (this->lanes.size() > 1) {
+        for (size_t pass = 0; pass < count; pass++) {
+            auto& lane = this->lanes.at(pass % this->lanes.size());
+            const uint64_t value = passValue(pass);
+            const uint64_t previous = pass > 0 ? passValue(pass - 1) : frameStart;
+            lane.batch.add()
+                .wait(lane.semaphore, value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+                .signal(this->outSemaphore, value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+            if (previous > 0)
+                lane.batch.wait(this->outSemaphore, previous,
+                    VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        }
+    }
+
+    for (size_t i = 0; i < this->lanes.size(); i++)
+        this->lanes.at(i).batch.submit(vk.device.getComputeQueues().at(i));
 
     this->frameIdx++;
+    return count;
+}
+
+void Context::wait(Vulkan& vk) {
+    // every submission of a frame finishes before its last pass signals
+    if (!this->outSemaphore.wait(vk.device, this->frameIdx * vk.generationCount))
+        throw LSFG::vulkan_error(VK_TIMEOUT, "Semaphore wait timed out");
 }
@@ -3,94 +3,288 @@
 #include "core/commandpool.hpp"
 #include "core/descriptorpool.hpp"
 #include "core/instance.hpp"
+#include "core/image.hpp"
+#include "core/pipelinecache.hpp"
+#include "core/semaphore.hpp"
 #include "pool/shaderpool.hpp"
 #include "common/exception.hpp"
 #include "common/utils.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <exception>
+#include <algorithm>
 #include <cstdint>
 #include <optional>
+#include <sstream>
 #include <cstdlib>
 #include <ctime>
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 using namespace LSFG;
 using namespace LSFG_3_1;
 
 namespace {
+    /// Maximum number of compute queues generation passes are spread over.
+    constexpr uint64_t MAX_LANES = 4;
+
+    /// Parameters the device was initialized with.
+    struct InitParams {
+        uint64_t deviceUUID; // zero for a shared device
+        VkDevice sharedDevice; // null for an owned device
+        bool isHdr;
+        float flowScale;
+        uint64_t generationCount;
+        bool variableCount;
+        bool dynamicTimestamps;
+        bool multiQueue;
+        bool pipelined;
+
+        bool operator==(const InitParams&) const = default;
+    };
+
     std::optional<Core::Instance> instance;
     std::optional<Vulkan> device;
+    std::optional<InitParams> initParams;
     std::unordered_map<int32_t, Context> contexts;
+    std::string pipelineCachePath;
+
+    /// Check whether the current device can be kept for a new initialization.
+    /// A device with different parameters is finalized, unless contexts still use it.
+    bool keepDevice(const InitParams& params) {
+        if (!device.has_value())
+            return false;
+        if (initParams == params)
+            return true;
+        if (!contexts.empty())
+            throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
+                "LSFG already initialized with different parameters");
+
+        finalize();
+        return false;
+    }
+
+    /// Get the pipeline cache file for a device, keyed by device and driver version.
+    std::string getPipelineCachePath(const std::string& cacheDirectory, const Core::Device& device) {
+        if (cacheDirectory.empty())
+            return {};
+
+        const auto& properties = device.getProperties();
+        std::ostringstream path;
+        path << cacheDirectory << "/pipelines_3_1_" << std::hex
+             << properties.vendorID << '_' << properties.deviceID << '_'
+             << properties.driverVersion << ".bin";
+        return path.str();
+    }
+
+    /// Write the pipeline cache to disk if new pipelines were compiled.
+    void savePipelineCache() {
+        if (pipelineCachePath.empty() || !device->shaders.takeDirty())
+            return;
+
+        try {
+            device->shaders.getPipelineCache().save(device->device, pipelineCachePath);
+        } catch (const std::exception&) {
+            // the pipeline cache is only an optimization
+        }
+    }
+
+    /// Create the objects shared by all contexts, once the device is set up.
+    void setupDevice(const std::function<std::vector<uint8_t>(const std::string&)>& loader,
+            const std::string& cacheDirectory) {
+        contexts = std::unordered_map<int32_t, Context>();
+
+        // with a variable count, passes are set up for every count up to the maximum
+        const uint64_t slotCount = Utils::getPassSlots(*device).size();
+        device->commandPool = Core::CommandPool(device->device);
+        device->descriptorPool = Core::DescriptorPool(device->device, static_cast<uint32_t>(
+            (slotCount + device->generationCount - 1) / device->generationCount));
+
+        device->resources = Pool::ResourcePool(device->isHdr, device->flowScale);
+        pipelineCachePath = getPipelineCachePath(cacheDirectory, device->device);
+        device->shaders = Pool::ShaderPool(loader,
+            Core::PipelineCache(device->device, pipelineCachePath));
+
+        std::srand(static_cast<uint32_t>(std::time(nullptr)));
+    }
+
+    /// Add a context and save any pipelines it compiled.
+    int32_t addContext(Context&& context) {
+        const int32_t id = std::rand();
+        contexts.emplace(id, std::move(context));
+
+        savePipelineCache();
+        return id;
+    }
 }
 
 void LSFG_3_1::initialize(uint64_t deviceUUID,
-        bool isHdr, float flowScale, uint64_t generationCount,
-        const std::function<std::vector<uint8_t>(const std::string&)>& loader) {
-    if (instance.has_value() || device.has_value())
+        bool isHdr, float flowScale, uint64_t generationCount, bool variableCount,
+        bool dynamicTimestamps, bool multiQueue, bool pipelined,
+        const std::function<std::vector<uint8_t>(const std::string&)>& loader,
+        const std::string& cacheDirectory) {
+    const InitParams params{
+        .deviceUUID = deviceUUID, .sharedDevice = VK_NULL_HANDLE,
+        .isHdr = isHdr, .flowScale = flowScale,
+        .generationCount = generationCount, .variableCount = variableCount,
+        .dynamicTimestamps = dynamicTimestamps,
+        .multiQueue = multiQueue, .pipelined = pipelined
+    };
+    if (keepDevice(params))
         return;
 
     instance.emplace();
     device.emplace(Vulkan {
-        .device{*instance, deviceUUID},
+        .device{*instance, deviceUUID,
+            multiQueue ? static_cast<uint32_t>(std::min<uint64_t>(generationCount, MAX_LANES)) : 1,
+            pipelined},
         .generationCount = generationCount,
+        .variableCount = variableCount,
+        .dynamicTimestamps = dynamicTimestamps,
         .flowScale = flowScale,
         .isHdr = isHdr
     });
-    contexts = std::unordered_map<int32_t, Context>();
-
-    device->commandPool = Core::CommandPool(device->device);
-    device->descriptorPool = Core::DescriptorPool(device->device);
+    device->laneCount = device->device.getComputeQueues().size();
+    device->pipelined = device->device.getPriorityQueue().has_value();
+    setupDevice(loader, cacheDirectory);
+    initParams = params;
+}
 
-    device->resources = Pool::ResourcePool(device->isHdr, device->flowScale);
-    device->shaders = Pool::ShaderPool(loader);
+void LSFG_3_1::initializeShared(VkPhysicalDevice physicalDevice, VkDevice logicalDevice,
+        uint32_t queueFamily, VkQueue queue,
+        const VkPhysicalDeviceProperties& properties,
+        const VkPhysicalDeviceMemoryProperties& memoryProperties,
+        bool isHdr, float flowScale, uint64_t generationCount, bool variableCount,
+        bool dynamicTimestamps,
+        const std::function<std::vector<uint8_t>(const std::string&)>& loader,
+        const std::string& cacheDirectory) {
+    const InitParams params{
+        .deviceUUID = 0, .sharedDevice = logicalDevice,
+        .isHdr = isHdr, .flowScale = flowScale,
+        .generationCount = generationCount, .variableCount = variableCount,
+        .dynamicTimestamps = dynamicTimestamps,
+        .multiQueue = false, .pipelined = false
+    };
+    if (keepDevice(params))
+        return;
 
-    std::srand(static_cast<uint32_t>(std::time(nullptr)));
+    // without an instance, the device belongs to the caller
+    device.emplace(Vulkan {
+        .device{physicalDevice, logicalDevice, queueFamily, queue,
+            properties, memoryProperties},
+        .generationCount = generationCount,
+        .variableCount = variableCount,
+        .dynamicTimestamps = dynamicTimestamps,
+        .flowScale = flowScale,
+        .isHdr = isHdr
+    });
+    setupDevice(loader, cacheDirectory);
+    initParams = params;
 }
 
 int32_t LSFG_3_1::createContext(
         int in0, int in1, const std::vector<int>& outN,
-        VkExtent2D extent, VkFormat format) {
-    if (!instance.has_value() || !device.has_value())
+        VkExtent2D extent, VkFormat format, VkFormat inFormat,
+        int inSem, int outSem) {
+    if (!device.has_value())
+        throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED, "LSFG not initialized");
+
+    // import images and semaphores from the file descriptors
+    const auto importImage = [&](int fd, VkFormat imageFormat, VkImageUsageFlags usage) {
+        return Core::Image(device->device, extent, imageFormat, usage,
+            VK_IMAGE_ASPECT_COLOR_BIT, fd);
+    };
+    std::vector<Core::Image> outImgs;
+    outImgs.reserve(outN.size());
+    for (const int fd : outN)
+        outImgs.push_back(importImage(fd, format,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT));
+
+    std::optional<Core::Semaphore> inSemaphore;
+    std::optional<Core::Semaphore> outSemaphore;
+    if (inSem >= 0)
+        inSemaphore.emplace(device->device, inSem, true);
+    if (outSem >= 0)
+        outSemaphore.emplace(device->device, outSem, true);
+
+    return addContext(Context(*device,
+        importImage(in0, inFormat, VK_IMAGE_USAGE_SAMPLED_BIT),
+        importImage(in1, inFormat, VK_IMAGE_USAGE_SAMPLED_BIT),
+        outImgs, format,
+        inSemaphore, outSemaphore));
+}
+
+int32_t LSFG_3_1::createSharedContext(
+        VkImage in0, VkImage in1, const std::vector<VkImage>& outN,
+        VkExtent2D extent, VkFormat format, VkFormat inFormat,
+        VkSemaphore inSem, VkSemaphore outSem) {
+    if (!device.has_value())
         throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED, "LSFG not initialized");
 
-    const int32_t id = std::rand();
-    contexts.emplace(id, Context(*device, in0, in1, outN, extent, format));
-    return id;
+    std::vector<Core::Image> outImgs;
+    outImgs.reserve(outN.size());
+    for (VkImage image : outN)
+        outImgs.emplace_back(device->device, image, extent, format);
+
+    return addContext(Context(*device,
+        Core::Image(device->device, in0, extent, inFormat),
+        Core::Image(device->device, in1, extent, inFormat),
+        outImgs, format,
+        Core::Semaphore(device->device, inSem), Core::Semaphore(device->device, outSem)));
 }
 
-void LSFG_3_1::presentContext(int32_t id, int inSem, const std::vector<int>& outSem) {
-    if (!instance.has_value() || !device.has_value())
+uint64_t LSFG_3_1::presentContext(int32_t id, uint64_t passCount,
+        const std::vector<float>& timestamps) {
+    if (!device.has_value())
         throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED, "LSFG not initialized");
 
     auto it = contexts.find(id);
     if (it == contexts.end())
         throw LSFG::vulkan_error(VK_ERROR_UNKNOWN, "Context not found");
 
-    it->second.present(*device, inSem, outSem);
+    return it->second.present(*device, passCount, timestamps);
+}
+
+uint64_t LSFG_3_1::getBarrierCount(int32_t id) {
+    auto it = contexts.find(id);
+    if (it == contexts.end())
+        throw LSFG::vulkan_error(VK_ERROR_UNKNOWN, "Context not found");
+
+    return it->second.getBarrierCount();
 }
 
 void LSFG_3_1::deleteContext(int32_t id) {
-    if (!instance.has_value() || !device.has_value())
+    if (!device.has_value())
         throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED, "LSFG not initialized");
 
     auto it = contexts.find(id);
     if (it == contexts.end())
         throw LSFG::vulkan_error(VK_ERROR_DEVICE_LOST, "No such context");
 
-    vkDeviceWaitIdle(device->device.handle());
+    // a shared device may be in use elsewhere, so only wait for the context itself
+    if (instance.has_value())
+        vkDeviceWaitIdle(device->device.handle());
+    else
+        it->second.wait(*device);
     contexts.erase(it);
 }
 
 void LSFG_3_1::finalize() {
-    if (!instance.has_value() || !device.has_value())
+    if (!device.has_value())
         return;
 
-    vkDeviceWaitIdle(device->device.handle());
+    if (instance.has_value())
+        vkDeviceWaitIdle(device->device.handle());
+    else
+        for (auto& [id, context] : contexts)
+            context.wait(*device);
+    savePipelineCache();
     contexts.clear();
     device.reset();
+    initParams.reset();
     instance.reset();
 }
@@ -1,6 +1,6 @@
 #include "v3_1/shaders/alpha.hpp"
 #include "common/utils.hpp"
-#include "core/commandbuffer.hpp"
+#include "common/graph.hpp"
 #include "core/image.hpp"
 
 #include <vulkan/vulkan_core.h>
@@ -88,52 +88,25 @@ Alpha::Alpha(Vulkan& vk, Core::Image inImg) : inImg(std::move(inImg)) {
             .build();
 }
 
-void Alpha::Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount) {
+void Alpha::Dispatch(Utils::FrameGraph& graph, uint64_t frameCount) {
     // first pass
     const auto halfExtent = this->tempImgs1.at(0).getExtent();
     uint32_t threadsX = (halfExtent.width + 7) >> 3;
     uint32_t threadsY = (halfExtent.height + 7) >> 3;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->inImg)
-        .addR2W(this->tempImgs1)
-        .build();
-
-    this->pipelines.at(0).bind(buf);
-    this->descriptorSets.at(0).bind(buf, this->pipelines.at(0));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(0), this->descriptorSets.at(0), threadsX, threadsY);
 
     // second pass
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1)
-        .addR2W(this->tempImgs2)
-        .build();
-
-    this->pipelines.at(1).bind(buf);
-    this->descriptorSets.at(1).bind(buf, this->pipelines.at(1));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(1), this->descriptorSets.at(1), threadsX, threadsY);
 
     // third pass
     const auto quarterExtent = this->tempImgs3.at(0).getExtent();
     threadsX = (quarterExtent.width + 7) >> 3;
     threadsY = (quarterExtent.height + 7) >> 3;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2)
-        .addR2W(this->tempImgs3)
-        .build();
-
-    this->pipelines.at(2).bind(buf);
-    this->descriptorSets.at(2).bind(buf, this->pipelines.at(2));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(2), this->descriptorSets.at(2), threadsX, threadsY);
 
     // fourth pass
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs3)
-        .addR2W(this->outImgs.at(frameCount % 3))
-        .build();
-
-    this->pipelines.at(3).bind(buf);
-    this->lastDescriptorSet.at(frameCount % 3).bind(buf, this->pipelines.at(3));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(3), this->lastDescriptorSet.at(frameCount % 3),
+        threadsX, threadsY);
 }
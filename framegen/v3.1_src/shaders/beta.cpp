@@ -1,6 +1,6 @@
 #include "v3_1/shaders/beta.hpp"
 #include "common/utils.hpp"
-#include "core/commandbuffer.hpp"
+#include "common/graph.hpp"
 #include "core/image.hpp"
 
 #include <vulkan/vulkan_core.h>
@@ -50,8 +50,10 @@ Beta::Beta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs)
         VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER, VK_COMPARE_OP_NEVER, true);
     for (size_t i = 0; i < 3; i++)
         this->firstDescriptorSet.at(i) = Core::DescriptorSet(vk.device, vk.descriptorPool, this->shaderModules.at(0));
-    for (size_t i = 0; i < 4; i++)
+    for (size_t i = 0; i < 3; i++)
         this->descriptorSets.at(i) = Core::DescriptorSet(vk.device, vk.descriptorPool, this->shaderModules.at(i + 1));
+    for (size_t i = 0; i < 2; i++)
+        this->lastDescriptorSet.at(i) = Core::DescriptorSet(vk.device, vk.descriptorPool, this->shaderModules.at(4));
     this->buffer = vk.resources.getBuffer(vk.device, 0.5F);
 
     // create internal images/outputs
@@ -61,10 +63,11 @@ Beta::Beta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs)
         this->tempImgs2.at(i) = Core::Image(vk.device, extent);
     }
 
-    for (size_t i = 0; i < 6; i++)
-        this->outImgs.at(i) = Core::Image(vk.device,
-            { extent.width >> i, extent.height >> i },
-            VK_FORMAT_R8_UNORM);
+    for (size_t i = 0; i < 2; i++)
+        for (size_t j = 0; j < 6; j++)
+            this->outImgs.at(i).at(j) = Core::Image(vk.device,
+                { extent.width >> j, extent.height >> j },
+                VK_FORMAT_R8_UNORM);
 
     // hook up shaders
     for (size_t i = 0; i < 3; i++) {
@@ -91,71 +94,37 @@ Beta::Beta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs)
         .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs1)
         .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs2)
         .build();
-    this->descriptorSets.at(3).update(vk.device)
-        .add(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, this->buffer)
-        .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
-        .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2)
-        .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->outImgs)
-        .build();
+    for (size_t i = 0; i < 2; i++)
+        this->lastDescriptorSet.at(i).update(vk.device)
+            .add(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, this->buffer)
+            .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
+            .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2)
+            .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->outImgs.at(i))
+            .build();
 }
 
-void Beta::Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount) {
+void Beta::Dispatch(Utils::FrameGraph& graph, uint64_t frameCount) {
     // first pass
     const auto extent = this->tempImgs1.at(0).getExtent();
     uint32_t threadsX = (extent.width + 7) >> 3;
     uint32_t threadsY = (extent.height + 7) >> 3;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->inImgs.at(0))
-        .addW2R(this->inImgs.at(1))
-        .addW2R(this->inImgs.at(2))
-        .addR2W(this->tempImgs1)
-        .build();
-
-    this->pipelines.at(0).bind(buf);
-    this->firstDescriptorSet.at(frameCount % 3).bind(buf, this->pipelines.at(0));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(0), this->firstDescriptorSet.at(frameCount % 3),
+        threadsX, threadsY);
 
     // second pass
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1)
-        .addR2W(this->tempImgs2)
-        .build();
-
-    this->pipelines.at(1).bind(buf);
-    this->descriptorSets.at(0).bind(buf, this->pipelines.at(1));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(1), this->descriptorSets.at(0), threadsX, threadsY);
 
     // third pass
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2)
-        .addR2W(this->tempImgs1)
-        .build();
-
-    this->pipelines.at(2).bind(buf);
-    this->descriptorSets.at(1).bind(buf, this->pipelines.at(2));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(2), this->descriptorSets.at(1), threadsX, threadsY);
 
     // fourth pass
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1)
-        .addR2W(this->tempImgs2)
-        .build();
-
-    this->pipelines.at(3).bind(buf);
-    this->descriptorSets.at(2).bind(buf, this->pipelines.at(3));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(3), this->descriptorSets.at(2), threadsX, threadsY);
 
     // fifth pass
     threadsX = (extent.width + 31) >> 5;
     threadsY = (extent.height + 31) >> 5;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2)
-        .addR2W(this->outImgs)
-        .build();
-
-    this->pipelines.at(4).bind(buf);
-    this->descriptorSets.at(3).bind(buf, this->pipelines.at(4));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(4), this->lastDescriptorSet.at(frameCount % 2),
+        threadsX, threadsY);
 }
@@ -1,6 +1,6 @@
 #include "v3_1/shaders/delta.hpp"
 #include "common/utils.hpp"
-#include "core/commandbuffer.hpp"
+#include "common/graph.hpp"
 #include "core/image.hpp"
 
 #include <vulkan/vulkan_core.h>
@@ -14,11 +14,12 @@
 using namespace LSFG_3_1::Shaders;
 
 Delta::Delta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs1,
-        Core::Image inImg2,
+        std::array<Core::Image, 2> inImgs2,
         std::optional<Core::Image> optImg1,
         std::optional<Core::Image> optImg2,
-        std::optional<Core::Image> optImg3)
-        : inImgs1(std::move(inImgs1)), inImg2(std::move(inImg2)),
+        std::optional<Core::Image> optImg3,
+        size_t lane)
+        : inImgs1(std::move(inImgs1)), inImgs2(std::move(inImgs2)),
           optImg1(std::move(optImg1)), optImg2(std::move(optImg2)),
           optImg3(std::move(optImg3)) {
     // create resources
@@ -101,11 +102,15 @@ Delta::Delta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs1,
         VK_FORMAT_R16G16B16A16_SFLOAT);
 
     // hook up shaders
-    for (size_t pass_idx = 0; pass_idx < vk.generationCount; pass_idx++) {
-        auto& pass = this->passes.emplace_back();
-        pass.buffer = vk.resources.getBuffer(vk.device,
-            static_cast<float>(pass_idx + 1) / static_cast<float>(vk.generationCount + 1),
-            false, !this->optImg1.has_value());
+    const auto slots = Utils::getPassSlots(vk);
+    this->passes.resize(slots.size());
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        if (slots.at(slot).pass % vk.laneCount != lane)
+            continue;
+
+        auto& pass = this->passes.at(slot);
+        pass.buffer = vk.resources.getBuffer(vk.device, slots.at(slot).timestamp,
+            false, !this->optImg1.has_value(), vk.dynamicTimestamps);
         for (size_t i = 0; i < 3; i++) {
             pass.firstDescriptorSet.at(i) = Core::DescriptorSet(vk.device, vk.descriptorPool,
                 this->shaderModules.at(0));
@@ -144,17 +149,19 @@ Delta::Delta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs1,
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs1)
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs2)
             .build();
-        pass.descriptorSets.at(3) = Core::DescriptorSet(vk.device, vk.descriptorPool,
-            this->shaderModules.at(4));
-        pass.descriptorSets.at(3).update(vk.device)
-            .add(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, pass.buffer)
-            .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
-            .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(2))
-            .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2)
-            .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->optImg1)
-            .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->inImg2)
-            .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->outImg1)
-            .build();
+        for (size_t i = 0; i < 2; i++) {
+            pass.fifthDescriptorSet.at(i) = Core::DescriptorSet(vk.device, vk.descriptorPool,
+                this->shaderModules.at(4));
+            pass.fifthDescriptorSet.at(i).update(vk.device)
+                .add(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, pass.buffer)
+                .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
+                .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(2))
+                .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2)
+                .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->optImg1)
+                .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->inImgs2.at(i))
+                .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->outImg1)
+                .build();
+        }
         for (size_t i = 0; i < 3; i++) {
             pass.sixthDescriptorSet.at(i) = Core::DescriptorSet(vk.device, vk.descriptorPool,
                 this->shaderModules.at(5));
@@ -170,36 +177,36 @@ Delta::Delta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs1,
                 .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs2.at(1))
                 .build();
         }
-        pass.descriptorSets.at(4) = Core::DescriptorSet(vk.device, vk.descriptorPool,
+        pass.descriptorSets.at(3) = Core::DescriptorSet(vk.device, vk.descriptorPool,
             this->shaderModules.at(6));
-        pass.descriptorSets.at(4).update(vk.device)
+        pass.descriptorSets.at(3).update(vk.device)
             .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2.at(1))
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs1.at(0))
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs1.at(1))
             .build();
-        pass.descriptorSets.at(5) = Core::DescriptorSet(vk.device, vk.descriptorPool,
+        pass.descriptorSets.at(4) = Core::DescriptorSet(vk.device, vk.descriptorPool,
             this->shaderModules.at(7));
-        pass.descriptorSets.at(5).update(vk.device)
+        pass.descriptorSets.at(4).update(vk.device)
             .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs1.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs1.at(1))
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs2.at(0))
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs2.at(1))
             .build();
-        pass.descriptorSets.at(6) = Core::DescriptorSet(vk.device, vk.descriptorPool,
+        pass.descriptorSets.at(5) = Core::DescriptorSet(vk.device, vk.descriptorPool,
             this->shaderModules.at(8));
-        pass.descriptorSets.at(6).update(vk.device)
+        pass.descriptorSets.at(5).update(vk.device)
             .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->tempImgs2.at(1))
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs1.at(0))
             .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->tempImgs1.at(1))
             .build();
-        pass.descriptorSets.at(7) = Core::DescriptorSet(vk.device, vk.descriptorPool,
+        pass.descriptorSets.at(6) = Core::DescriptorSet(vk.device, vk.descriptorPool,
             this->shaderModules.at(9));
-        pass.descriptorSets.at(7).update(vk.device)
+        pass.descriptorSets.at(6).update(vk.device)
             .add(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, pass.buffer)
             .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(0))
             .add(VK_DESCRIPTOR_TYPE_SAMPLER, this->samplers.at(2))
@@ -211,130 +218,43 @@ Delta::Delta(Vulkan& vk, std::array<std::array<Core::Image, 4>, 3> inImgs1,
     }
 }
 
-void Delta::Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount, uint64_t pass_idx) {
-    auto& pass = this->passes.at(pass_idx);
+void Delta::Dispatch(Utils::FrameGraph& graph, uint64_t frameCount, uint64_t slot) {
+    auto& pass = this->passes.at(slot);
 
     // first shader
     const auto extent = this->tempImgs1.at(0).getExtent();
     const uint32_t threadsX = (extent.width + 7) >> 3;
     const uint32_t threadsY = (extent.height + 7) >> 3;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->inImgs1.at((frameCount + 2) % 3))
-        .addW2R(this->inImgs1.at(frameCount % 3))
-        .addW2R(this->optImg1)
-        .addR2W(this->tempImgs1.at(0))
-        .addR2W(this->tempImgs1.at(1))
-        .addR2W(this->tempImgs1.at(2))
-        .build();
-
-    this->pipelines.at(0).bind(buf);
-    pass.firstDescriptorSet.at(frameCount % 3).bind(buf, this->pipelines.at(0));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(0), pass.firstDescriptorSet.at(frameCount % 3),
+        threadsX, threadsY);
 
     // second shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1.at(0))
-        .addW2R(this->tempImgs1.at(1))
-        .addW2R(this->tempImgs1.at(2))
-        .addR2W(this->tempImgs2)
-        .build();
-
-    this->pipelines.at(1).bind(buf);
-    pass.descriptorSets.at(0).bind(buf, this->pipelines.at(1));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(1), pass.descriptorSets.at(0), threadsX, threadsY);
 
     // third shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2)
-        .addR2W(this->tempImgs1)
-        .build();
-
-    this->pipelines.at(2).bind(buf);
-    pass.descriptorSets.at(1).bind(buf, this->pipelines.at(2));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(2), pass.descriptorSets.at(1), threadsX, threadsY);
 
     // fourth shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1)
-        .addR2W(this->tempImgs2)
-        .build();
-
-    this->pipelines.at(3).bind(buf);
-    pass.descriptorSets.at(2).bind(buf, this->pipelines.at(3));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(3), pass.descriptorSets.at(2), threadsX, threadsY);
 
     // fifth shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2)
-        .addW2R(this->optImg1)
-        .addW2R(this->inImg2)
-        .addR2W(this->outImg1)
-        .build();
-
-    this->pipelines.at(4).bind(buf);
-    pass.descriptorSets.at(3).bind(buf, this->pipelines.at(4));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(4), pass.fifthDescriptorSet.at(frameCount % 2),
+        threadsX, threadsY);
 
     // sixth shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->inImgs1.at((frameCount + 2) % 3))
-        .addW2R(this->inImgs1.at(frameCount % 3))
-        .addW2R(this->optImg1)
-        .addW2R(this->optImg2)
-        .addR2W(this->tempImgs2.at(0))
-        .addR2W(this->tempImgs2.at(1))
-        .build();
-
-    this->pipelines.at(5).bind(buf);
-    pass.sixthDescriptorSet.at(frameCount % 3).bind(buf, this->pipelines.at(5));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(5), pass.sixthDescriptorSet.at(frameCount % 3),
+        threadsX, threadsY);
 
     // seventh shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2.at(0))
-        .addW2R(this->tempImgs2.at(1))
-        .addR2W(this->tempImgs1.at(0))
-        .addR2W(this->tempImgs1.at(1))
-        .build();
-
-    this->pipelines.at(6).bind(buf);
-    pass.descriptorSets.at(4).bind(buf, this->pipelines.at(6));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(6), pass.descriptorSets.at(3), threadsX, threadsY);
 
     // eighth shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1.at(0))
-        .addW2R(this->tempImgs1.at(1))
-        .addR2W(this->tempImgs2.at(0))
-        .addR2W(this->tempImgs2.at(1))
-        .build();
-    this->pipelines.at(7).bind(buf);
-    pass.descriptorSets.at(5).bind(buf, this->pipelines.at(7));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(7), pass.descriptorSets.at(4), threadsX, threadsY);
 
     // ninth shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs2.at(0))
-        .addW2R(this->tempImgs2.at(1))
-        .addW2R(this->optImg3)
-        .addR2W(this->tempImgs1.at(0))
-        .addR2W(this->tempImgs1.at(1))
-        .build();
-
-    this->pipelines.at(8).bind(buf);
-    pass.descriptorSets.at(6).bind(buf, this->pipelines.at(8));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(8), pass.descriptorSets.at(5), threadsX, threadsY);
 
     // tenth shader
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->tempImgs1.at(0))
-        .addW2R(this->tempImgs1.at(1))
-        .addW2R(this->optImg3)
-        .addR2W(this->outImg2)
-        .build();
-
-    this->pipelines.at(9).bind(buf);
-    pass.descriptorSets.at(7).bind(buf, this->pipelines.at(9));
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipelines.at(9), pass.descriptorSets.at(6), threadsX, threadsY);
 }
@@ -1,9 +1,10 @@
 #pragma once
 
+#include "core/buffer.hpp"
 #include "core/image.hpp"
 #include "core/semaphore.hpp"
-#include "core/fence.hpp"
 #include "core/commandbuffer.hpp"
+#include "core/submitbatch.hpp"
 #include "shaders/alpha.hpp"
 #include "shaders/beta.hpp"
 #include "shaders/delta.hpp"
@@ -14,8 +15,10 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <optional>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <array>
 
 namespace LSFG_3_1P {
@@ -28,28 +31,49 @@ namespace LSFG_3_1P {
         /// Create a context
         ///
         /// @param vk The Vulkan instance to use.
-        /// @param in0 File descriptor for the first input image.
-        /// @param in1 File descriptor for the second input image.
-        /// @param outN File descriptors for the output images.
-        /// @param extent The size of the images.
+        /// @param in0 The first input image, which also defines the size.
+        /// @param in1 The second input image.
+        /// @param outN The output images, or empty to create them internally.
         /// @param format The format of the images.
+        /// @param inSem The input timeline semaphore, if any.
+        /// @param outSem The output timeline semaphore, or none to create it internally.
         ///
         /// @throws LSFG::vulkan_error if the context fails to initialize.
         ///
         Context(Vulkan& vk,
-            int in0, int in1, const std::vector<int>& outN,
-            VkExtent2D extent, VkFormat format);
+            Core::Image in0, Core::Image in1, const std::vector<Core::Image>& outN,
+            VkFormat format,
+            std::optional<Core::Semaphore> inSem, std::optional<Core::Semaphore> outSem);
 
         ///
         /// Present on the context.
         ///
-        /// @param inSem Semaphore to wait on before starting the generation.
-        /// @param outSem Semaphores to signal after each generation is done.
+        /// Generation of frame n waits for the input semaphore to reach n + 1
+        /// and signals the output semaphore to n * generationCount + pass + 1,
+        /// with the last pass signaling (n + 1) * generationCount.
+        ///
+        /// @param vk The Vulkan instance to use.
+        /// @param count The number of passes to run, ignored for the first frames.
+        /// @param timestamps The timestamp of each pass, or empty to space them evenly.
+        ///     Only used with dynamic timestamps, if there is one for every pass that runs.
+        /// @return The number of passes that run.
         ///
         /// @throws LSFG::vulkan_error if the context fails to present.
+        /// @throws std::logic_error if the pass count is invalid.
+        ///
+        uint64_t present(Vulkan& vk, uint64_t count, const std::vector<float>& timestamps);
+
+        ///
+        /// Wait for all frames presented on the context to finish generating.
+        ///
+        /// @param vk The Vulkan instance to use.
+        ///
+        /// @throws LSFG::vulkan_error if waiting fails.
         ///
-        void present(Vulkan& vk,
-            int inSem, const std::vector<int>& outSem);
+        void wait(Vulkan& vk);
+
+        /// Get the number of pipeline barriers recorded per frame.
+        [[nodiscard]] size_t getBarrierCount() const { return this->barrierCount; }
 
         // Trivially copyable, moveable and destructible
         Context(const Context&) = default;
@@ -60,26 +84,39 @@ namespace LSFG_3_1P {
     private:
         Core::Image inImg_0, inImg_1; // inImg_0 is next when fc % 2 == 0
         uint64_t frameIdx{0};
+        size_t barrierCount{0};
 
-        struct RenderData {
-            Core::Semaphore inSemaphore; // signaled when input is ready
-            std::vector<Core::Semaphore> internalSemaphores; // signaled when first step is done
-            std::vector<Core::Semaphore> outSemaphores; // signaled when each pass is done
-            std::vector<Core::Fence> completionFences; // fence for completion of each pass
+        std::optional<Core::Semaphore> inSemaphore; // reaches fc + 1 when input is ready
+        Core::Semaphore internalSemaphore; // reaches fc + 1 when first step is done
+        Core::Semaphore outSemaphore; // reaches fc * n + pass + 1 when each pass is done
 
+        struct RenderData {
             Core::CommandBuffer cmdBuffer1;
-            std::vector<Core::CommandBuffer> cmdBuffers2; // command buffers for second step
-
-            bool shouldWait{false};
+            std::vector<Core::CommandBuffer> cmdBuffers2; // second step, indexed by pass slot
         };
-        std::array<RenderData, 8> data;
+        std::array<RenderData, 6> data; // one variant per fc % 6, reused from frame 6 on
+        // timestamps indexed by variant * slotCount + slot, copied into the passes if dynamic
+        Core::Buffer timestamps;
+        size_t slotCount{0};
 
         Shaders::Mipmaps mipmaps;
         std::array<Shaders::Alpha, 7> alpha;
         Shaders::Beta beta;
-        std::array<Shaders::Gamma, 7> gamma;
-        std::array<Shaders::Delta, 3> delta;
-        Shaders::Generate generate;
+
+        /// Generation chains and submissions for one compute queue.
+        struct Lane {
+            std::array<Shaders::Gamma, 7> gamma;
+            std::array<Shaders::Delta, 3> delta;
+            Shaders::Generate generate;
+            Core::Semaphore semaphore; // reaches fc * n + pass + 1 when a pass on this lane is done
+            Core::SubmitBatch batch; // reused for every frame
+        };
+        std::vector<Lane> lanes; // pass p runs on lane p % lanes.size()
+        Core::SubmitBatch analysisBatch; // first step submissions in pipelined mode
+
+        /// Record the command buffers for a frame, for every pass count or only the full one.
+        void record(Vulkan& vk, RenderData& data, uint64_t frameCount,
+            VkCommandBufferUsageFlags usage, bool everyCount);
     };
 
 }
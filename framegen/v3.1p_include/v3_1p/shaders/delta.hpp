@@ -1,16 +1,17 @@
 #pragma once
 
 #include "core/buffer.hpp"
-#include "core/commandbuffer.hpp"
 #include "core/descriptorset.hpp"
 #include "core/image.hpp"
 #include "core/pipeline.hpp"
 #include "core/sampler.hpp"
 #include "core/shadermodule.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 
 #include <array>
 #include <cstdint>
+#include <cstddef>
 #include <optional>
 #include <vector>
 
@@ -29,27 +30,34 @@ namespace LSFG_3_1P::Shaders {
         /// Initialize the shaderchain.
         ///
         /// @param inImgs1 Three sets of two RGBA images, corresponding to a frame count % 3.
-        /// @param inImg2 Second Input image
+        /// @param inImgs2 Two second input images, corresponding to a frame count % 2.
         /// @param optImg1 Optional image for non-first passes.
         /// @param optImg2 Second optional image for non-first passes.
+        /// @param lane Generation lane, only passes with pass % laneCount == lane are set up.
         ///
         /// @throws LSFG::vulkan_error if resource creation fails.
         ///
         Delta(Vulkan& vk, std::array<std::array<Core::Image, 2>, 3> inImgs1,
-            Core::Image inImg2,
+            std::array<Core::Image, 2> inImgs2,
             std::optional<Core::Image> optImg1,
-            std::optional<Core::Image> optImg2);
+            std::optional<Core::Image> optImg2,
+            size_t lane);
 
         ///
         /// Dispatch the shaderchain.
         ///
-        void Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount, uint64_t pass_idx,
+        /// @param graph Frame graph to add the dispatches to
+        ///
+        void Dispatch(Utils::FrameGraph& graph, uint64_t frameCount, uint64_t slot,
             bool last);
 
         /// Get the first output image
         [[nodiscard]] const auto& getOutImage1() const { return this->outImg1; }
         /// Get the second output image
         [[nodiscard]] const auto& getOutImage2() const { return this->outImg2; }
+        /// Get the constant buffer of a pass slot
+        [[nodiscard]] const auto& getBuffer(size_t slot) const {
+            return this->passes.at(slot).buffer; }
 
         /// Trivially copyable, moveable and destructible
         Delta(const Delta&) noexcept = default;
@@ -64,13 +72,14 @@ namespace LSFG_3_1P::Shaders {
         struct DeltaPass {
             Core::Buffer buffer;
             std::array<Core::DescriptorSet, 3> firstDescriptorSet;
-            std::array<Core::DescriptorSet, 8> descriptorSets;
+            std::array<Core::DescriptorSet, 7> descriptorSets;
+            std::array<Core::DescriptorSet, 2> fifthDescriptorSet;
             std::array<Core::DescriptorSet, 3> sixthDescriptorSet;
         };
         std::vector<DeltaPass> passes;
 
         std::array<std::array<Core::Image, 2>, 3> inImgs1;
-        Core::Image inImg2;
+        std::array<Core::Image, 2> inImgs2;
         std::optional<Core::Image> optImg1, optImg2;
         std::array<Core::Image, 3> tempImgs1;
         std::array<Core::Image, 2> tempImgs2;
@@ -1,16 +1,17 @@
 #pragma once
 
 #include "core/buffer.hpp"
-#include "core/commandbuffer.hpp"
 #include "core/descriptorset.hpp"
 #include "core/image.hpp"
 #include "core/pipeline.hpp"
 #include "core/sampler.hpp"
 #include "core/shadermodule.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 
 #include <array>
 #include <cstdint>
+#include <cstddef>
 #include <optional>
 #include <vector>
 
@@ -29,21 +30,28 @@ namespace LSFG_3_1P::Shaders {
         /// Initialize the shaderchain.
         ///
         /// @param inImgs1 Three sets of two RGBA images, corresponding to a frame count % 3.
-        /// @param inImg2 Second Input image
+        /// @param inImgs2 Two second input images, corresponding to a frame count % 2.
         /// @param optImg Optional image for non-first passes.
+        /// @param lane Generation lane, only passes with pass % laneCount == lane are set up.
         ///
         /// @throws LSFG::vulkan_error if resource creation fails.
         ///
         Gamma(Vulkan& vk, std::array<std::array<Core::Image, 2>, 3> inImgs1,
-            Core::Image inImg2, std::optional<Core::Image> optImg);
+            std::array<Core::Image, 2> inImgs2, std::optional<Core::Image> optImg,
+            size_t lane);
 
         ///
         /// Dispatch the shaderchain.
         ///
-        void Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount, uint64_t pass_idx);
+        /// @param graph Frame graph to add the dispatches to
+        ///
+        void Dispatch(Utils::FrameGraph& graph, uint64_t frameCount, uint64_t slot);
 
         /// Get the output image
         [[nodiscard]] const auto& getOutImage() const { return this->outImg; }
+        /// Get the constant buffer of a pass slot
+        [[nodiscard]] const auto& getBuffer(size_t slot) const {
+            return this->passes.at(slot).buffer; }
 
         /// Trivially copyable, moveable and destructible
         Gamma(const Gamma&) noexcept = default;
@@ -58,12 +66,13 @@ namespace LSFG_3_1P::Shaders {
         struct GammaPass {
             Core::Buffer buffer;
             std::array<Core::DescriptorSet, 3> firstDescriptorSet;
-            std::array<Core::DescriptorSet, 4> descriptorSets;
+            std::array<Core::DescriptorSet, 3> descriptorSets;
+            std::array<Core::DescriptorSet, 2> lastDescriptorSet;
         };
         std::vector<GammaPass> passes;
 
         std::array<std::array<Core::Image, 2>, 3> inImgs1;
-        Core::Image inImg2;
+        std::array<Core::Image, 2> inImgs2;
         std::optional<Core::Image> optImg;
         std::array<Core::Image, 3> tempImgs1;
         std::array<Core::Image, 2> tempImgs2;
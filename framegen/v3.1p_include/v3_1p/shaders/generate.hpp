@@ -1,19 +1,20 @@
 #pragma once
 
 #include "core/buffer.hpp"
-#include "core/commandbuffer.hpp"
 #include "core/descriptorset.hpp"
 #include "core/image.hpp"
 #include "core/pipeline.hpp"
 #include "core/sampler.hpp"
 #include "core/shadermodule.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <array>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 
 namespace LSFG_3_1P::Shaders {
 
@@ -34,19 +35,27 @@ namespace LSFG_3_1P::Shaders {
         /// @param inImg3 Input image 3.
         /// @param inImg4 Input image 4.
         /// @param inImg5 Input image 5.
-        /// @param fds File descriptors for the output images.
+        /// @param outImgs Output images, or empty to create them internally.
+        /// @param lane Generation lane, only passes with pass % laneCount == lane are set up.
         ///
         /// @throws LSFG::vulkan_error if resource creation fails.
         ///
         Generate(Vulkan& vk,
             Core::Image inImg1, Core::Image inImg2,
             Core::Image inImg3, Core::Image inImg4, Core::Image inImg5,
-            const std::vector<int>& fds, VkFormat format);
+            const std::vector<Core::Image>& outImgs, VkFormat format,
+            size_t lane);
 
         ///
         /// Dispatch the shaderchain.
         ///
-        void Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount, uint64_t pass_idx);
+        /// @param graph Frame graph to add the dispatches to
+        ///
+        void Dispatch(Utils::FrameGraph& graph, uint64_t frameCount, uint64_t slot);
+
+        /// Get the constant buffer of a pass slot
+        [[nodiscard]] const auto& getBuffer(size_t slot) const {
+            return this->passes.at(slot).buffer; }
 
         /// Trivially copyable, moveable and destructible
         Generate(const Generate&) noexcept = default;
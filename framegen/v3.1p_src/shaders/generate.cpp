@@ -1,6 +1,6 @@
 #include "v3_1p/shaders/generate.hpp"
 #include "common/utils.hpp"
-#include "core/commandbuffer.hpp"
+#include "common/graph.hpp"
 #include "core/image.hpp"
 
 #include <vulkan/vulkan_core.h>
@@ -15,7 +15,8 @@ using namespace LSFG_3_1P::Shaders;
 Generate::Generate(Vulkan& vk,
     Core::Image inImg1, Core::Image inImg2,
     Core::Image inImg3, Core::Image inImg4, Core::Image inImg5,
-    const std::vector<int>& fds, VkFormat format)
+    const std::vector<Core::Image>& outImgs, VkFormat format,
+    size_t lane)
         : inImg1(std::move(inImg1)), inImg2(std::move(inImg2)),
           inImg3(std::move(inImg3)), inImg4(std::move(inImg4)),
           inImg5(std::move(inImg5)) {
@@ -32,16 +33,22 @@ Generate::Generate(Vulkan& vk,
 
     // create internal images/outputs
     const VkExtent2D extent = this->inImg1.getExtent();
-    for (size_t i = 0; i < vk.generationCount; i++)
-        this->outImgs.emplace_back(vk.device, extent, format,
-            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-            VK_IMAGE_ASPECT_COLOR_BIT, fds.empty() ? -1 : fds.at(i));
+    this->outImgs.resize(vk.generationCount);
+    for (size_t i = lane; i < vk.generationCount; i += vk.laneCount)
+        this->outImgs.at(i) = outImgs.empty()
+            ? Core::Image(vk.device, extent, format)
+            : outImgs.at(i);
 
     // hook up shaders
-    for (size_t i = 0; i < vk.generationCount; i++) {
-        auto& pass = this->passes.emplace_back();
-        pass.buffer = vk.resources.getBuffer(vk.device,
-            static_cast<float>(i + 1) / static_cast<float>(vk.generationCount + 1));
+    const auto slots = Utils::getPassSlots(vk);
+    this->passes.resize(slots.size());
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        if (slots.at(slot).pass % vk.laneCount != lane)
+            continue;
+
+        auto& pass = this->passes.at(slot);
+        pass.buffer = vk.resources.getBuffer(vk.device, slots.at(slot).timestamp,
+            false, false, vk.dynamicTimestamps);
         for (size_t j = 0; j < 2; j++) {
             pass.descriptorSet.at(j) = Core::DescriptorSet(vk.device, vk.descriptorPool,
                 this->shaderModule);
@@ -53,30 +60,19 @@ Generate::Generate(Vulkan& vk,
                 .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->inImg3)
                 .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->inImg4)
                 .add(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, this->inImg5)
-                .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->outImgs.at(i))
+                .add(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, this->outImgs.at(slots.at(slot).pass))
                 .build();
         }
     }
 }
 
-void Generate::Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount, uint64_t pass_idx) {
-    auto& pass = this->passes.at(pass_idx);
+void Generate::Dispatch(Utils::FrameGraph& graph, uint64_t frameCount, uint64_t slot) {
+    auto& pass = this->passes.at(slot);
 
     // first pass
     const auto extent = this->inImg1.getExtent();
     const uint32_t threadsX = (extent.width + 15) >> 4;
     const uint32_t threadsY = (extent.height + 15) >> 4;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R(this->inImg1)
-        .addW2R(this->inImg2)
-        .addW2R(this->inImg3)
-        .addW2R(this->inImg4)
-        .addW2R(this->inImg5)
-        .addR2W(this->outImgs.at(pass_idx))
-        .build();
-
-    this->pipeline.bind(buf);
-    pass.descriptorSet.at(frameCount % 2).bind(buf, this->pipeline);
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipeline, pass.descriptorSet.at(frameCount % 2), threadsX, threadsY);
 }
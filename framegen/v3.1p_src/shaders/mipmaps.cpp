@@ -1,7 +1,7 @@
 #include "v3_1p/shaders/mipmaps.hpp"
 #include "common/utils.hpp"
+#include "common/graph.hpp"
 #include "core/image.hpp"
-#include "core/commandbuffer.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -48,18 +48,11 @@ Mipmaps::Mipmaps(Vulkan& vk,
             .build();
 }
 
-void Mipmaps::Dispatch(const Core::CommandBuffer& buf, uint64_t frameCount) {
+void Mipmaps::Dispatch(Utils::FrameGraph& graph, uint64_t frameCount) {
     // first pass
     const auto flowExtent = this->outImgs.at(0).getExtent();
     const uint32_t threadsX = (flowExtent.width + 63) >> 6;
     const uint32_t threadsY = (flowExtent.height + 63) >> 6;
 
-    Utils::BarrierBuilder(buf)
-        .addW2R((frameCount % 2 == 0) ? this->inImg_0 : this->inImg_1)
-        .addR2W(this->outImgs)
-        .build();
-
-    this->pipeline.bind(buf);
-    this->descriptorSets.at(frameCount % 2).bind(buf, this->pipeline);
-    buf.dispatch(threadsX, threadsY, 1);
+    graph.dispatch(this->pipeline, this->descriptorSets.at(frameCount % 2), threadsX, threadsY);
 }
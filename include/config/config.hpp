@@ -24,9 +24,27 @@ namespace Config {
         bool performance{false};
         /// Whether HDR is enabled
         bool hdr{false};
+        /// Whether new frames are analyzed on their own queue, overlapping generation
+        bool pipelined{false};
+        /// Whether generation passes are spread over several compute queues
+        bool multiQueue{false};
+        /// Whether presents are spread evenly over the interval between real frames,
+        /// only done by the presenter thread so the game itself is never held back
+        bool pacing{false};
+        /// Maximum number of real frames the game may run ahead of frame generation, 0 for no limit
+        size_t maxFramesInFlight{0};
+        /// Refresh rate to fill with up to multiplier presents per frame, 0 to always use the multiplier
+        size_t targetFps{0};
 
         /// Experimental flag for overriding the synchronization method.
         VkPresentModeKHR e_present;
+        /// Experimental flag for running frame generation on the game's device.
+        bool e_singleDevice{false};
+        /// Experimental flag for handing the game images shared with frame generation.
+        bool e_virtualSwapchain{false};
+        /// Experimental flag for presenting generated frames from a separate thread.
+        /// Only applies to devices created while set, acquires still wait for the thread.
+        bool e_presentThread{false};
 
         /// Path to the configuration file.
         std::filesystem::path config_file;
@@ -47,6 +65,16 @@ namespace Config {
     ///
     void updateConfig(const std::string& file);
 
+    ///
+    /// Quickly check whether the configuration file may contain an entry for a game,
+    /// without parsing it. Anything unusual is treated as a potential match.
+    ///
+    /// @param file The path to the configuration file.
+    /// @param name The name of the executable to check.
+    /// @return False only if the game is certainly not configured.
+    ///
+    bool mayMatchGame(const std::string& file, const std::pair<std::string, std::string>& name);
+
     ///
     /// Get the configuration for a game.
     ///
@@ -14,8 +14,18 @@ const std::string DEFAULT_CONFIG = R"(version = 1
 # flow_scale = 0.7
 # performance_mode = true
 # hdr_mode = false
+# pipelined_mode = true
+# multi_queue_mode = true
+# frame_pacing = true # needs experimental_present_thread
+# max_frames_in_flight = 1
+# target_fps = 144
 #
 # experimental_present_mode = "fifo"
+# experimental_single_device = true
+# experimental_virtual_swapchain = true
+# present from a separate thread, needs a restart to take effect. the game's
+# vkAcquireNextImageKHR still waits until every queued present is done.
+# experimental_present_thread = true
 
 [[game]] # default vkcube entry
 exe = "vkcube"
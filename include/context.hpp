@@ -5,12 +5,20 @@
 #include "mini/commandpool.hpp"
 #include "mini/image.hpp"
 #include "mini/semaphore.hpp"
+#include "swapchain.hpp"
+#include "utils/latency.hpp"
+#include "utils/pacing.hpp"
+#include "utils/spsc.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <exception>
+#include <atomic>
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 ///
@@ -19,26 +27,59 @@
 class LsContext {
 public:
     ///
-    /// Create the swapchain context.
+    /// Check whether the configuration file changed since it was last read.
+    ///
+    /// @return Whether updateConfiguration would reread it.
+    ///
+    static bool configurationChanged();
+
+    ///
+    /// Reread the configuration if the file changed since it was last read,
+    /// shutting down LSFG so that new contexts use the updated settings.
+    /// Must be called from the thread presenting, before creating a context,
+    /// and after all contexts still being built have been dropped.
+    ///
+    /// @param info The device information to use.
+    ///
+    static void updateConfiguration(const Hooks::DeviceInfo& info);
+
+    ///
+    /// Create the swapchain context. This is safe to call on a worker thread, as it does
+    /// not touch the swapchain images. Call recordCopies before the first present.
     ///
     /// @param info The device information to use.
     /// @param swapchain The Vulkan swapchain to use.
     /// @param extent The extent of the swapchain images.
+    /// @param swapchainFormat The format of the swapchain images.
     /// @param swapchainImages The swapchain images to use.
+    /// @param virtualSwapchain The virtual swapchain the game renders into, or nullptr.
     ///
     /// @throws LSFG::vulkan_error if any Vulkan call fails.
     ///
     LsContext(const Hooks::DeviceInfo& info, VkSwapchainKHR swapchain,
-        VkExtent2D extent, const std::vector<VkImage>& swapchainImages);
+        VkExtent2D extent, VkFormat swapchainFormat, const std::vector<VkImage>& swapchainImages,
+        std::shared_ptr<VirtualSwapchain> virtualSwapchain);
 
     ///
-    /// Custom present logic.
+    /// Record the copies between the swapchain images and the images shared with lsfg.
+    /// Must be called once, from the thread presenting, as the game may destroy the
+    /// swapchain while the context is still being built.
+    ///
+    /// @param info The device information to use.
+    ///
+    /// @throws LSFG::vulkan_error if any Vulkan call fails.
+    ///
+    void recordCopies(const Hooks::DeviceInfo& info);
+
+    ///
+    /// Custom present logic. With a presenter thread, the generated frames and the real frame
+    /// are presented asynchronously, and errors surface on the following call.
     ///
     /// @param info The device information to use.
     /// @param pNext Unknown pointer set in the present info structure.
     /// @param queue The Vulkan queue to present the frame on.
     /// @param gameRenderSemaphores The semaphores to wait on before presenting.
-    /// @param presentIdx The index of the swapchain image to present.
+    /// @param presentIdx The index of the swapchain image to present, or of the virtual image.
     /// @return The result of the Vulkan present operation, which can be VK_SUCCESS or VK_SUBOPTIMAL_KHR.
     ///
     /// @throws LSFG::vulkan_error if any Vulkan call fails.
@@ -46,35 +87,91 @@ class LsContext {
     VkResult present(const Hooks::DeviceInfo& info, const void* pNext, VkQueue queue,
         const std::vector<VkSemaphore>& gameRenderSemaphores, uint32_t presentIdx);
 
-    // Non-copyable, trivially moveable and destructible
+    ///
+    /// Wait for the presenter thread to finish all queued presents,
+    /// after which the swapchain may be used from the calling thread.
+    ///
+    void waitIdle() noexcept;
+
+    // Non-copyable, trivially moveable and destructible. The presenter thread
+    // is only started once the context has been moved into place.
     LsContext(const LsContext&) = delete;
     LsContext& operator=(const LsContext&) = delete;
     LsContext(LsContext&&) = default;
     LsContext& operator=(LsContext&&) = default;
     ~LsContext() = default;
 private:
+    ///
+    /// Acquire, copy and present the generated frames of a frame, followed by the real frame.
+    ///
+    /// @param info The device information to use.
+    /// @param pNext Unknown pointer set in the present info structure.
+    /// @param queue The Vulkan queue to present the frames on.
+    /// @param frame The index of the frame to present.
+    /// @param presentIdx The index of the swapchain image to present, or of the virtual image.
+    /// @param passCount The number of frames generated for this frame.
+    /// @param paced Whether to space out the presents, only off the game's thread.
+    /// @return The result of the Vulkan present operation, which can be VK_SUCCESS or VK_SUBOPTIMAL_KHR.
+    ///
+    /// @throws LSFG::vulkan_error if any Vulkan call fails.
+    ///
+    VkResult presentFrames(const Hooks::DeviceInfo& info, const void* pNext, VkQueue queue,
+        uint64_t frame, uint32_t presentIdx, uint64_t passCount, bool paced);
+
     VkSwapchainKHR swapchain;
     std::vector<VkImage> swapchainImages;
     VkExtent2D extent;
+    std::shared_ptr<VirtualSwapchain> virtualSwapchain; // replaces frame_0/frame_1 if set
 
-    std::shared_ptr<int32_t> lsfgCtxId; // lsfg context id
-    Mini::Image frame_0, frame_1; // frames shared with lsfg. write to frame_0 when fc % 2 == 0
+    // frames shared with lsfg, in the swapchain format. write to frame_0 when fc % 2 == 0
+    Mini::Image frame_0, frame_1;
     std::vector<Mini::Image> out_n; // output images shared with lsfg, indexed by framegen id
+    Mini::Semaphore inSemaphore; // timeline shared with lsfg, reaches fc + 1 when frame fc is copied
+    Mini::Semaphore outSemaphore; // timeline shared with lsfg, reaches fc * n + i + 1 when out_n is ready
+    std::shared_ptr<int32_t> lsfgCtxId; // lsfg context id, destroyed before the objects it uses
 
     Mini::CommandPool cmdPool;
     uint64_t frameIdx{0};
+    Pacing::Scheduler pacing; // spaces out presents on the presenter thread if frame pacing is enabled
+    Latency::Limiter limiter; // holds the game back if frames in flight are limited
+    Pacing::Scheduler frameRate; // estimates the game's frame interval with a target fps or pacing
+    std::vector<float> timestamps; // timestamps of the generated frames, reused between frames
 
-    struct RenderPassInfo {
-        Mini::CommandBuffer preCopyBuf; // copy from swapchain image to frame_0/frame_1
-        std::array<Mini::Semaphore, 2> preCopySemaphores; // signal when preCopyBuf is done
-
-        std::vector<Mini::Semaphore> renderSemaphores; // signal when lsfg is done with frame n
+    // copy from swapchain image to frame_0/frame_1, indexed by image * 2 + fc % 2. unused
+    // with a virtual swapchain, as the game renders into the shared images directly.
+    std::vector<Mini::CommandBuffer> preCopyBufs;
+    // copy from out_n to swapchain image, indexed by n * image count + image
+    std::vector<Mini::CommandBuffer> postCopyBufs;
 
+    struct RenderPassInfo {
         std::vector<Mini::Semaphore> acquireSemaphores; // signal for swapchain image n
 
-        std::vector<Mini::CommandBuffer> postCopyBufs; // copy from out_n to swapchain image
-        std::vector<Mini::Semaphore> postCopySemaphores; // signal when postCopyBuf is done
-        std::vector<Mini::Semaphore> prevPostCopySemaphores; // signal for previous postCopyBuf
-    }; // data for a single render pass
+        std::vector<Mini::Semaphore> postCopySemaphores; // signal when the post-copy is done
+        std::vector<Mini::Semaphore> prevPostCopySemaphores; // signal for previous post-copy
+        Mini::Semaphore copySemaphore; // signal when the pre-copy is done, if nothing is generated
+    }; // semaphores for a single render pass, created once and reused
     std::array<RenderPassInfo, 8> passInfos; // allocate 8 because why not
+
+    bool threaded{false}; // whether presents go through the presenter thread
+    struct PresentRequest {
+        Hooks::DeviceInfo info;
+        VkQueue queue;
+        uint64_t frameIdx;
+        uint32_t presentIdx;
+        uint64_t passCount;
+        bool stop; // exit the presenter thread
+    };
+    struct Presenter {
+        Utils::SpscQueue<PresentRequest, 4> requests; // game thread to presenter thread
+        uint64_t queued{0}; // requests pushed, only touched by the game thread
+        std::atomic<uint64_t> done{0}; // requests finished by the presenter thread
+        std::atomic<VkResult> result{VK_SUCCESS}; // result of the latest present
+
+        std::mutex errorMutex;
+        std::exception_ptr error; // first error since the last present call
+
+        std::thread thread;
+        ~Presenter(); // stops the thread after all queued presents
+    }; // started on the first present, owns the swapchain while it has work queued
+    std::unique_ptr<Presenter> presenter; // declared last, so it stops before anything it uses
 };
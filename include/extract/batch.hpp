@@ -0,0 +1,31 @@
+#pragma once
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Extract {
+
+    ///
+    /// Translate all shaders required by a mode on a pool of worker threads.
+    ///
+    /// @param performance Whether to translate the performance mode shaders.
+    /// @return The translated SPIR-V bytecode for each shader name.
+    ///
+    /// @throws std::runtime_error if a shader cannot be found or translated.
+    ///
+    std::unordered_map<std::string, std::vector<uint8_t>> translateShaders(bool performance);
+
+    ///
+    /// Create a shader loader for the framegen library. The first request
+    /// translates all shaders of the mode in a batch, subsequent requests
+    /// are served from the batch.
+    ///
+    /// @param performance Whether to load the performance mode shaders.
+    /// @return Function returning the SPIR-V bytecode of a shader by name.
+    ///
+    std::function<std::vector<uint8_t>(const std::string&)> createShaderLoader(bool performance);
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+namespace Extract {
+
+    ///
+    /// Translate DXBC bytecode to SPIR-V bytecode, consulting the
+    /// on-disk cache first and storing the result on a miss.
+    ///
+    /// @param bytecode The DXBC bytecode to translate.
+    /// @param hit Set to whether the result was loaded from the cache, may be nullptr.
+    /// @return The translated SPIR-V bytecode.
+    ///
+    std::vector<uint8_t> translateShaderCached(std::span<const uint8_t> bytecode,
+        bool* hit = nullptr);
+
+}
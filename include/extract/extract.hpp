@@ -3,24 +3,37 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <span>
 
 namespace Extract {
 
     ///
-    /// Extract all known shaders.
+    /// Extract all known shaders. Safe to call from several threads, later calls
+    /// wait for the first one and then return immediately or rethrow its error.
+    ///
+    /// @param dll Path to Lossless.dll, or empty to search the usual install locations.
     ///
     /// @throws std::runtime_error if shader extraction fails.
     ///
-    void extractShaders();
+    void extractShaders(const std::string& dll);
 
     ///
-    /// Get a shader by name.
+    /// Get a shader by name, extracting all shaders first if necessary. Must not
+    /// run concurrently with configuration changes, as it reads the configured dll.
     ///
     /// @param name The name of the shader to get.
-    /// @return The shader bytecode.
+    /// @return A view of the shader bytecode, valid for the process lifetime.
+    ///
+    /// @throws std::runtime_error if shader extraction fails or the shader is not found.
+    ///
+    std::span<const uint8_t> getShader(const std::string& name);
+
+    ///
+    /// Get the names of all shaders used by a mode.
     ///
-    /// @throws std::runtime_error if the shader is not found.
+    /// @param performance Whether to list the performance mode shaders.
+    /// @return The shader names.
     ///
-    std::vector<uint8_t> getShader(const std::string& name);
+    std::vector<std::string> getShaderNames(bool performance);
 
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+namespace Extract {
+
+    ///
+    /// Strip debug information and no-ops from translated SPIR-V bytecode.
+    ///
+    /// @param bytecode The SPIR-V bytecode to strip.
+    /// @return The stripped SPIR-V bytecode.
+    ///
+    /// @throws std::runtime_error if the bytecode is malformed.
+    ///
+    std::vector<uint8_t> stripShader(std::span<const uint8_t> bytecode);
+
+}
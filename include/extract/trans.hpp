@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <vector>
+#include <span>
 
 namespace Extract {
 
@@ -11,6 +12,6 @@ namespace Extract {
     /// @param bytecode The DXBC bytecode to translate.
     /// @return The translated SPIR-V bytecode.
     ///
-    std::vector<uint8_t> translateShader(std::vector<uint8_t> bytecode);
+    std::vector<uint8_t> translateShader(std::span<const uint8_t> bytecode);
 
 }
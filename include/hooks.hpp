@@ -14,9 +14,13 @@ namespace Hooks {
         VkDevice device;
         VkPhysicalDevice physicalDevice;
         std::pair<uint32_t, VkQueue> queue; // graphics family
+        bool singleDevice; // frame generation runs on this device instead of its own
+        bool queueLocks; // the game's queue calls serialize with the presenter thread
     };
 
     /// Map of hooked Vulkan functions.
     extern std::unordered_map<std::string, PFN_vkVoidFunction> hooks;
+    /// Map of hooked queue functions, only installed with the presenter thread.
+    extern std::unordered_map<std::string, PFN_vkVoidFunction> queueHooks;
 
 }
@@ -5,6 +5,24 @@
 #include <cstdint>
 
 namespace Layer {
+    ///
+    /// Make the layer transparent to instances and devices created on this thread while
+    /// an object of this type exists, such as the ones frame generation creates for itself.
+    ///
+    class Bypass {
+    public:
+        Bypass() noexcept;
+
+        // Non-copyable, non-moveable
+        Bypass(const Bypass&) = delete;
+        Bypass& operator=(const Bypass&) = delete;
+        Bypass(Bypass&&) = delete;
+        Bypass& operator=(Bypass&&) = delete;
+        ~Bypass();
+    private:
+        bool previous;
+    };
+
     /// Call to the original vkCreateInstance function.
     VkResult ovkCreateInstance(
         const VkInstanceCreateInfo* pCreateInfo,
@@ -65,7 +83,7 @@ namespace Layer {
         const VkSwapchainCreateInfoKHR* pCreateInfo,
         const VkAllocationCallbacks* pAllocator,
         VkSwapchainKHR* pSwapchain);
-    /// Call to the original vkQueuePresentKHR function.
+    /// Call to the original vkQueuePresentKHR function, holding the queue lock.
     VkResult ovkQueuePresentKHR(
         VkQueue queue,
         const VkPresentInfoKHR* pPresentInfo);
@@ -171,6 +189,16 @@ namespace Layer {
         VkDevice device,
         const VkSemaphoreGetFdInfoKHR* pGetFdInfo,
         int* pFd);
+    /// Call to the original vkWaitSemaphoresKHR function.
+    VkResult ovkWaitSemaphores(
+        VkDevice device,
+        const VkSemaphoreWaitInfo* pWaitInfo,
+        uint64_t timeout);
+    /// Call to the original vkGetSemaphoreCounterValueKHR function.
+    VkResult ovkGetSemaphoreCounterValue(
+        VkDevice device,
+        VkSemaphore semaphore,
+        uint64_t* pValue);
 
     /// Call to the original vkGetDeviceQueue function.
     void ovkGetDeviceQueue(
@@ -178,12 +206,30 @@ namespace Layer {
         uint32_t queueFamilyIndex,
         uint32_t queueIndex,
         VkQueue* pQueue);
-    /// Call to the original vkQueueSubmit function.
+    /// Call to the original vkQueueSubmit function, holding the queue lock.
     VkResult ovkQueueSubmit(
         VkQueue queue,
         uint32_t submitCount,
         const VkSubmitInfo* pSubmits,
         VkFence fence);
+    /// Call to the original vkQueueSubmit2 function, holding the queue lock.
+    VkResult ovkQueueSubmit2(
+        VkQueue queue,
+        uint32_t submitCount,
+        const VkSubmitInfo2* pSubmits,
+        VkFence fence);
+    /// Call to the original vkQueueBindSparse function, holding the queue lock.
+    VkResult ovkQueueBindSparse(
+        VkQueue queue,
+        uint32_t bindInfoCount,
+        const VkBindSparseInfo* pBindInfo,
+        VkFence fence);
+    /// Call to the original vkQueueWaitIdle function, holding the queue lock.
+    VkResult ovkQueueWaitIdle(
+        VkQueue queue);
+    /// Call to the original vkDeviceWaitIdle function, holding all queue locks.
+    VkResult ovkDeviceWaitIdle(
+        VkDevice device);
 
     /// Call to the original vkCmdPipelineBarrier function.
     void ovkCmdPipelineBarrier(
@@ -207,6 +253,15 @@ namespace Layer {
         uint32_t regionCount,
         const VkImageBlit* pRegions,
         VkFilter filter);
+    /// Call to the original vkCmdCopyImage function.
+    void ovkCmdCopyImage(
+        VkCommandBuffer commandBuffer,
+        VkImage srcImage,
+        VkImageLayout srcImageLayout,
+        VkImage dstImage,
+        VkImageLayout dstImageLayout,
+        uint32_t regionCount,
+        const VkImageCopy* pRegions);
 
     /// Call to the original vkAcquireNextImageKHR function.
     VkResult ovkAcquireNextImageKHR(
@@ -4,6 +4,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <optional>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -45,10 +47,13 @@ namespace Mini {
         ///
         /// Begin recording commands in the command buffer.
         ///
+        /// @param usage Usage flags. Without VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        ///     the command buffer stays in Full state and can be submitted repeatedly.
+        ///
         /// @throws std::logic_error if the command buffer is in Empty state
         /// @throws LSFG::vulkan_error if beginning the command buffer fails.
         ///
-        void begin();
+        void begin(VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
         ///
         /// End recording commands in the command buffer.
@@ -61,16 +66,22 @@ namespace Mini {
         ///
         /// Submit the command buffer to a queue.
         ///
+        /// The layer only records copies, so all semaphores are waited on at the transfer stage.
+        ///
         /// @param queue Vulkan queue to submit to
         /// @param waitSemaphores Semaphores to wait on before executing the command buffer
+        /// @param waitSemaphoreValues Values for the semaphores to wait on, ignored for binary ones
         /// @param signalSemaphores Semaphores to signal after executing the command buffer
+        /// @param signalSemaphoreValues Values for the semaphores to signal, ignored for binary ones
         ///
         /// @throws std::logic_error if the command buffer is not in Full state.
         /// @throws LSFG::vulkan_error if submission fails.
         ///
         void submit(VkQueue queue,
             const std::vector<VkSemaphore>& waitSemaphores = {},
-            const std::vector<VkSemaphore>& signalSemaphores = {});
+            std::optional<std::vector<uint64_t>> waitSemaphoreValues = std::nullopt,
+            const std::vector<VkSemaphore>& signalSemaphores = {},
+            std::optional<std::vector<uint64_t>> signalSemaphoreValues = std::nullopt);
 
         /// Get the state of the command buffer.
         [[nodiscard]] CommandBufferState getState() const { return *this->state; }
@@ -85,6 +96,7 @@ namespace Mini {
         ~CommandBuffer() = default;
     private:
         std::shared_ptr<CommandBufferState> state;
+        std::shared_ptr<VkCommandBufferUsageFlags> usage;
         std::shared_ptr<VkCommandBuffer> commandBuffer;
     };
 
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Mini {
+
+    ///
+    /// Record the creation of a Vulkan object on the calling thread.
+    ///
+    void countObject() noexcept;
+
+    ///
+    /// Get the number of Vulkan objects the calling thread created since its last call and reset it.
+    ///
+    /// @return The number of created objects.
+    ///
+    size_t takeObjectCount() noexcept;
+
+}
@@ -16,7 +16,7 @@ namespace Mini {
         Image() noexcept = default;
 
         ///
-        /// Create the image and export the backing fd
+        /// Create the image, optionally exporting the backing fd
         ///
         /// @param device Vulkan device
         /// @param physicalDevice Vulkan physical device
@@ -24,7 +24,7 @@ namespace Mini {
         /// @param format Vulkan format of the image
         /// @param usage Usage flags for the image
         /// @param aspectFlags Aspect flags for the image view
-        /// @param fd Pointer to an integer where the file descriptor will be stored.
+        /// @param fd Pointer to an integer where the file descriptor will be stored, or nullptr.
         ///
         /// @throws LSFG::vulkan_error if object creation fails.
         ///
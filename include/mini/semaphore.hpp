@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <memory>
 
 namespace Mini {
@@ -25,14 +26,44 @@ namespace Mini {
         Semaphore(VkDevice device);
 
         ///
-        /// Import a semaphore.
+        /// Create an exportable semaphore.
         ///
         /// @param device Vulkan device
-        /// @param fd File descriptor to import the semaphore from.
+        /// @param fd Pointer to an integer where the file descriptor will be stored, or nullptr.
+        /// @param timeline Whether to create a timeline semaphore starting at 0.
         ///
         /// @throws LSFG::vulkan_error if object creation fails.
         ///
-        Semaphore(VkDevice device, int* fd);
+        Semaphore(VkDevice device, int* fd, bool timeline = false);
+
+        ///
+        /// Export another file descriptor for an exportable semaphore.
+        ///
+        /// @return The file descriptor, owned by the caller.
+        ///
+        /// @throws LSFG::vulkan_error if the export fails.
+        ///
+        [[nodiscard]] int exportFd() const;
+
+        ///
+        /// Wait for a timeline semaphore to reach a value.
+        ///
+        /// @param value The value to wait for.
+        /// @param timeout The timeout in nanoseconds.
+        /// @return true if the value was reached, false if the wait timed out.
+        ///
+        /// @throws LSFG::vulkan_error if waiting fails.
+        ///
+        [[nodiscard]] bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+        ///
+        /// Get the current value of a timeline semaphore.
+        ///
+        /// @return The counter value.
+        ///
+        /// @throws LSFG::vulkan_error if the value cannot be read.
+        ///
+        [[nodiscard]] uint64_t getValue() const;
 
         /// Get the Vulkan handle.
         [[nodiscard]] auto handle() const { return *this->semaphore; }
@@ -45,6 +76,7 @@ namespace Mini {
         ~Semaphore() = default;
     private:
         std::shared_ptr<VkSemaphore> semaphore;
+        VkDevice device{};
     };
 
 }
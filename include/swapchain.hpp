@@ -0,0 +1,120 @@
+#pragma once
+
+#include "hooks.hpp"
+#include "mini/commandbuffer.hpp"
+#include "mini/commandpool.hpp"
+#include "mini/image.hpp"
+#include "mini/semaphore.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+///
+/// Swapchain images handed to the game in place of the real ones, so that the game renders
+/// straight into the frame generation inputs instead of having them copied every frame.
+///
+/// Images are acquired alternating between the first two, which are shared with LSFG.
+/// Presenting a virtual image copies it into the real swapchain.
+///
+class VirtualSwapchain {
+public:
+    ///
+    /// Check whether a swapchain can be replaced by a virtual one.
+    ///
+    /// @param createInfo The swapchain create info requested by the game.
+    /// @return true if the virtual images can mirror the real ones.
+    ///
+    static bool isSupported(const VkSwapchainCreateInfoKHR& createInfo);
+
+    ///
+    /// Create the virtual images for a swapchain.
+    ///
+    /// @param info The device information to use.
+    /// @param swapchain The real swapchain to present to.
+    /// @param createInfo The swapchain create info requested by the game.
+    /// @param swapchainImages The images of the real swapchain.
+    ///
+    /// @throws LSFG::vulkan_error if any Vulkan call fails.
+    ///
+    VirtualSwapchain(const Hooks::DeviceInfo& info, VkSwapchainKHR swapchain,
+        const VkSwapchainCreateInfoKHR& createInfo, const std::vector<VkImage>& swapchainImages);
+
+    ///
+    /// Acquire the next virtual image. This never blocks.
+    ///
+    /// @param info The device information to use.
+    /// @param semaphore The semaphore to signal once the image is available, or VK_NULL_HANDLE.
+    /// @param fence The fence to signal once the image is available, or VK_NULL_HANDLE.
+    /// @return The index of the acquired image.
+    ///
+    /// @throws LSFG::vulkan_error if any Vulkan call fails.
+    ///
+    uint32_t acquire(const Hooks::DeviceInfo& info, VkSemaphore semaphore, VkFence fence);
+
+    ///
+    /// Present a virtual image by copying it into the real swapchain.
+    ///
+    /// @param info The device information to use.
+    /// @param pNext Unknown pointer set in the present info structure.
+    /// @param queue The Vulkan queue to present the frame on.
+    /// @param waitSemaphores The semaphores to wait on before copying.
+    /// @param waitValues The values to wait for, ignored for binary semaphores.
+    /// @param imageIdx The index of the virtual image to present.
+    /// @return The result of the Vulkan present operation, which can be VK_SUCCESS or VK_SUBOPTIMAL_KHR.
+    ///
+    /// @throws LSFG::vulkan_error if any Vulkan call fails.
+    ///
+    VkResult present(const Hooks::DeviceInfo& info, const void* pNext, VkQueue queue,
+        const std::vector<VkSemaphore>& waitSemaphores, const std::vector<uint64_t>& waitValues,
+        uint32_t imageIdx);
+
+    ///
+    /// Hold back a shared image from being acquired until a timeline semaphore reaches a value.
+    ///
+    /// @param imageIdx The index of the shared image, 0 or 1.
+    /// @param timeline The timeline semaphore to wait on.
+    /// @param value The value the image is free at.
+    ///
+    void release(uint32_t imageIdx, VkSemaphore timeline, uint64_t value);
+
+    ///
+    /// Take the file descriptors of the two shared images, transferring ownership.
+    ///
+    /// @return The file descriptors, or -1 if they were already taken.
+    ///
+    std::array<int, 2> takeFds();
+
+    /// Get the virtual images, in the order returned to the game.
+    [[nodiscard]] const auto& getImages() const { return this->imageHandles; }
+
+    // Non-copyable, non-moveable, closes untaken file descriptors
+    VirtualSwapchain(const VirtualSwapchain&) = delete;
+    VirtualSwapchain& operator=(const VirtualSwapchain&) = delete;
+    VirtualSwapchain(VirtualSwapchain&&) = delete;
+    VirtualSwapchain& operator=(VirtualSwapchain&&) = delete;
+    ~VirtualSwapchain();
+private:
+    VkSwapchainKHR swapchain;
+    std::vector<VkImage> swapchainImages;
+
+    std::vector<Mini::Image> images; // only the first two are ever acquired
+    std::vector<VkImage> imageHandles;
+    std::array<int, 2> fds{-1, -1}; // exported memory of the shared images
+    std::array<std::pair<VkSemaphore, uint64_t>, 2> releases{}; // wait before reusing an image
+    uint64_t acquireIdx{0};
+    uint64_t presentIdx{0};
+
+    Mini::CommandPool cmdPool;
+    // copy from a shared image to a swapchain image, indexed by image * 2 + shared image
+    std::vector<Mini::CommandBuffer> copyBufs;
+
+    struct PresentInfo {
+        Mini::Semaphore acquireSemaphore; // signal for the swapchain image
+        Mini::Semaphore copySemaphore; // signal when the copy is done
+    }; // semaphores for a single present, created once and reused
+    std::array<PresentInfo, 8> presentInfos;
+};
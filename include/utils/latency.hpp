@@ -0,0 +1,63 @@
+#pragma once
+
+#include "mini/semaphore.hpp"
+#include "utils/pacing.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+namespace Latency {
+
+    ///
+    /// Bound the number of real frames the game runs ahead of frame generation.
+    ///
+    /// After presenting frame n, the game is held until frame n - maxFrames + 1 has been
+    /// generated, so that its next frame starts as frame generation catches up instead
+    /// of queueing behind it. The hold is a synchronous wait on the timeline semaphore.
+    /// The time from presenting a frame to its generated frames being ready is reported
+    /// periodically. Frames the limiter waits for are timed as the wait returns, others
+    /// when the next present finds them done, which is an upper bound.
+    ///
+    class Limiter {
+    public:
+        ///
+        /// Create a latency limiter.
+        ///
+        /// @param clock The time source to measure with.
+        ///
+        Limiter(Pacing::Clock clock = Pacing::Clock::steady());
+
+        ///
+        /// Hold the game after presenting a frame.
+        ///
+        /// @param timeline Timeline semaphore that reaches (n + 1) * generationCount
+        ///     once frame n is generated.
+        /// @param frame The index of the frame that was just presented.
+        /// @param generationCount The number of generated frames per real frame.
+        /// @param maxFrames The maximum number of frames in flight, at least 1.
+        ///
+        /// @throws LSFG::vulkan_error if waiting fails.
+        ///
+        void limit(const Mini::Semaphore& timeline, uint64_t frame,
+            uint64_t generationCount, size_t maxFrames);
+    private:
+        /// Record the latency of frames generated since the last observation.
+        void observe(const Mini::Semaphore& timeline, uint64_t frame,
+            uint64_t generationCount, std::chrono::nanoseconds time);
+
+        Pacing::Clock clock;
+
+        std::array<std::chrono::nanoseconds, 16> presentTimes{}; // indexed by frame % 16
+        uint64_t generated{0}; // frames seen as generated so far
+
+        // statistics since the last report
+        std::chrono::nanoseconds reportStart{};
+        std::chrono::nanoseconds latencySum{};
+        std::chrono::nanoseconds waitSum{};
+        size_t latencyCount{0};
+        size_t frameCount{0};
+    };
+
+}
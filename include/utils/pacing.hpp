@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <chrono>
+#include <cstddef>
+
+namespace Pacing {
+
+    ///
+    /// Time source used by the scheduler. Replacing it makes the
+    /// scheduler deterministic, for example when running without a display.
+    ///
+    struct Clock {
+        /// Get the current time.
+        std::function<std::chrono::nanoseconds()> now;
+        /// Block until the given time has passed.
+        std::function<void(std::chrono::nanoseconds)> sleepUntil;
+
+        /// Get a clock backed by std::chrono::steady_clock.
+        static Clock steady();
+    };
+
+    ///
+    /// Spread the presents of a frame evenly over the interval between real frames.
+    ///
+    /// The interval is estimated from the time between consecutive real frames,
+    /// present i of a frame is then released at i / count of that interval.
+    ///
+    class Scheduler {
+    public:
+        ///
+        /// Create a scheduler.
+        ///
+        /// @param clock The time source to use.
+        ///
+        Scheduler(Clock clock = Clock::steady());
+
+        ///
+        /// Mark the arrival of a real frame and update the interval estimate.
+        /// Long stalls, such as loading screens, reset the estimate.
+        ///
+        void beginFrame();
+
+        ///
+        /// Wait until present i of the current frame is due.
+        ///
+        /// @param i The index of the present within the frame.
+        /// @param count The number of presents per frame.
+        ///
+        void waitFor(size_t i, size_t count) const;
+
+        /// Get the estimated interval between real frames, or zero if unknown.
+        [[nodiscard]] std::chrono::nanoseconds getInterval() const { return this->interval; }
+        /// Get the measured time between the last two real frames, or zero if unknown.
+        [[nodiscard]] std::chrono::nanoseconds getLastDelta() const { return this->lastDelta; }
+    private:
+        Clock clock;
+
+        std::chrono::nanoseconds frameStart{};
+        std::chrono::nanoseconds interval{}; // smoothed time between real frames
+        std::chrono::nanoseconds lastDelta{}; // unsmoothed time between the last two real frames
+        size_t frameCount{0};
+    };
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "hooks.hpp"
+
+namespace Prewarm {
+
+    ///
+    /// Start bringing up the framegen device in the background.
+    /// This initializes LSFG for the active configuration and compiles
+    /// all pipelines of the active mode, while the game is still loading.
+    ///
+    /// @param info The device information to use.
+    ///
+    void start(const Hooks::DeviceInfo& info);
+
+    ///
+    /// Wait for a running pre-warm to finish. Errors are logged and ignored,
+    /// as the swapchain context initializes LSFG on its own if needed.
+    ///
+    /// @param info The device the swapchain context is created on.
+    ///
+    void wait(const Hooks::DeviceInfo& info) noexcept;
+
+}
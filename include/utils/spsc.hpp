@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+
+namespace Utils {
+
+    ///
+    /// Bounded lock-free queue between exactly one producer and one consumer thread.
+    ///
+    /// Both sides block through atomic waits when the queue is full or empty,
+    /// so neither thread spins while the other one is busy.
+    ///
+    template<typename T, size_t N>
+    class SpscQueue {
+    public:
+        SpscQueue() noexcept = default;
+
+        ///
+        /// Push an element, blocking while the queue is full. Producer thread only.
+        ///
+        /// @param value The element to push.
+        ///
+        void push(const T& value) {
+            const size_t tail = this->tail.load(std::memory_order_relaxed);
+            size_t head = this->head.load(std::memory_order_acquire);
+            while (tail - head == N) {
+                this->head.wait(head, std::memory_order_acquire);
+                head = this->head.load(std::memory_order_acquire);
+            }
+
+            this->slots.at(tail % N) = value;
+            this->tail.store(tail + 1, std::memory_order_release);
+            this->tail.notify_one();
+        }
+
+        ///
+        /// Pop an element, blocking while the queue is empty. Consumer thread only.
+        ///
+        /// @return The oldest element in the queue.
+        ///
+        T pop() {
+            const size_t head = this->head.load(std::memory_order_relaxed);
+            size_t tail = this->tail.load(std::memory_order_acquire);
+            while (tail == head) {
+                this->tail.wait(tail, std::memory_order_acquire);
+                tail = this->tail.load(std::memory_order_acquire);
+            }
+
+            T value = this->slots.at(head % N);
+            this->head.store(head + 1, std::memory_order_release);
+            this->head.notify_one();
+            return value;
+        }
+
+        // Non-copyable, non-moveable
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+        SpscQueue(SpscQueue&&) = delete;
+        SpscQueue& operator=(SpscQueue&&) = delete;
+        ~SpscQueue() = default;
+    private:
+        std::array<T, N> slots{};
+        alignas(64) std::atomic<size_t> head{0}; // next element to pop
+        alignas(64) std::atomic<size_t> tail{0}; // next slot to push into
+    };
+
+}
@@ -7,6 +7,7 @@
 #include <utility>
 #include <string>
 #include <vector>
+#include <mutex>
 
 namespace Utils {
 
@@ -62,12 +63,51 @@ namespace Utils {
     /// @param post The pipeline stage to provide after the copy.
     /// @param makeSrcPresentable If true, the source image will be made presentable after the copy.
     /// @param makeDstPresentable If true, the destination image will be made presentable after the copy.
+    /// @param restingLayout Layout the image that is not made presentable is kept in
+    ///     between copies, or VK_IMAGE_LAYOUT_UNDEFINED if it is not tracked on this device.
+    /// @param sameFormat If true, both images share a format and are copied without conversion.
     ///
     void copyImage(VkCommandBuffer buf,
             VkImage src, VkImage dst,
             uint32_t width, uint32_t height,
             VkPipelineStageFlags pre, VkPipelineStageFlags post,
-            bool makeSrcPresentable, bool makeDstPresentable);
+            bool makeSrcPresentable, bool makeDstPresentable,
+            VkImageLayout restingLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            bool sameFormat = false);
+
+    ///
+    /// Submit a batch without command buffers, which only forwards semaphores.
+    ///
+    /// @param queue The Vulkan queue to submit to.
+    /// @param waitSemaphores The semaphores to wait on.
+    /// @param waitValues The values to wait for, ignored for binary semaphores.
+    /// @param signalSemaphores The semaphores to signal.
+    /// @param signalValues The values to signal, ignored for binary semaphores.
+    /// @param fence The fence to signal, or VK_NULL_HANDLE.
+    ///
+    /// @throws LSFG::vulkan_error if the submission fails.
+    ///
+    void forwardSemaphores(VkQueue queue,
+            const std::vector<VkSemaphore>& waitSemaphores, const std::vector<uint64_t>& waitValues,
+            const std::vector<VkSemaphore>& signalSemaphores, const std::vector<uint64_t>& signalValues,
+            VkFence fence = VK_NULL_HANDLE);
+
+    ///
+    /// Lock a queue for external synchronization. Every call into the next layer that uses a
+    /// queue takes this lock, as the presenter thread submits to the game's queues.
+    /// Several queues may share a lock.
+    ///
+    /// @param queue The queue to lock.
+    /// @return The held lock.
+    ///
+    std::unique_lock<std::mutex> lockQueue(VkQueue queue);
+
+    ///
+    /// Lock all queues, for calls that synchronize with the whole device.
+    ///
+    /// @return The held locks.
+    ///
+    std::vector<std::unique_lock<std::mutex>> lockAllQueues();
 
     ///
     /// Log a message at most n times.
@@ -99,4 +139,11 @@ namespace Utils {
     ///
     std::string getConfigFile();
 
+    ///
+    /// Get the cache directory path.
+    ///
+    /// @return The path to the cache directory.
+    ///
+    std::string getCacheDirectory();
+
 }
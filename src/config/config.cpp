@@ -101,7 +101,16 @@ void Config::updateConfig(const std::string& file) {
             .flowScale = toml::find_or(gameTable, "flow_scale", 1.0F),
             .performance = toml::find_or(gameTable, "performance_mode", false),
             .hdr = toml::find_or(gameTable, "hdr_mode", false),
+            .pipelined = toml::find_or(gameTable, "pipelined_mode", false),
+            .multiQueue = toml::find_or(gameTable, "multi_queue_mode", false),
+            .pacing = toml::find_or(gameTable, "frame_pacing", false),
+            .maxFramesInFlight = toml::find_or(gameTable, "max_frames_in_flight", 0U),
+            .targetFps = toml::find_or(gameTable, "target_fps", 0U),
             .e_present =   into_present(toml::find_or(gameTable, "experimental_present_mode", "")),
+            .e_singleDevice = toml::find_or(gameTable, "experimental_single_device", false),
+            .e_virtualSwapchain =
+                toml::find_or(gameTable, "experimental_virtual_swapchain", false),
+            .e_presentThread = toml::find_or(gameTable, "experimental_present_thread", false),
             .config_file = file,
             .timestamp = global.timestamp
         };
@@ -111,6 +120,8 @@ void Config::updateConfig(const std::string& file) {
             throw std::runtime_error("Multiplier cannot be less than 1");
         if (game.flowScale < 0.25F || game.flowScale > 1.0F)
             throw std::runtime_error("Flow scale must be between 0.25 and 1.0");
+        if (game.maxFramesInFlight > 8)
+            throw std::runtime_error("Max frames in flight cannot be more than 8");
         games[exe] = std::move(game);
     }
 
@@ -119,6 +130,42 @@ void Config::updateConfig(const std::string& file) {
     gameConfs = std::move(games);
 }
 
+bool Config::mayMatchGame(const std::string& file,
+        const std::pair<std::string, std::string>& name) {
+    std::ifstream in(file);
+    if (!in.is_open())
+        return true; // missing files are created by updateConfig
+
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.at(start) == '#'
+                || line.find("exe") == std::string::npos)
+            continue;
+
+        // only accept plain 'exe = "..."' lines, anything else might be a match
+        size_t pos = start;
+        if (line.compare(pos, 3, "exe") != 0)
+            return true;
+        pos = line.find_first_not_of(" \t", pos + 3);
+        if (pos == std::string::npos || line.at(pos) != '=')
+            return true;
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos || (line.at(pos) != '"' && line.at(pos) != '\''))
+            return true;
+        const char quote = line.at(pos);
+        const size_t end = line.find(quote, pos + 1);
+        if (end == std::string::npos)
+            return true;
+
+        const std::string exe = line.substr(pos + 1, end - pos - 1);
+        if (exe.find('\\') != std::string::npos
+                || name.first.ends_with(exe) || name.second == exe)
+            return true;
+    }
+    return false;
+}
+
 Configuration Config::getConfig(const std::pair<std::string, std::string>& name) {
     // process legacy environment variables
     if (std::getenv("LSFG_LEGACY")) {
@@ -139,9 +186,29 @@ Configuration Config::getConfig(const std::pair<std::string, std::string>& name)
         if (performance) conf.performance = std::string(performance) == "1";
         const char* hdr = std::getenv("LSFG_HDR_MODE");
         if (hdr) conf.hdr = std::string(hdr) == "1";
+        const char* pipelined = std::getenv("LSFG_PIPELINED_MODE");
+        if (pipelined) conf.pipelined = std::string(pipelined) == "1";
+        const char* multiQueue = std::getenv("LSFG_MULTI_QUEUE_MODE");
+        if (multiQueue) conf.multiQueue = std::string(multiQueue) == "1";
+        const char* pacing = std::getenv("LSFG_FRAME_PACING");
+        if (pacing) conf.pacing = std::string(pacing) == "1";
+        const char* maxFramesInFlight = std::getenv("LSFG_MAX_FRAMES_IN_FLIGHT");
+        if (maxFramesInFlight) conf.maxFramesInFlight = std::stoul(maxFramesInFlight);
+        const char* targetFps = std::getenv("LSFG_TARGET_FPS");
+        if (targetFps) conf.targetFps = std::stoul(targetFps);
         const char* e_present = std::getenv("LSFG_EXPERIMENTAL_PRESENT_MODE");
         if (e_present) conf.e_present = into_present(std::string(e_present));
+        const char* e_singleDevice = std::getenv("LSFG_EXPERIMENTAL_SINGLE_DEVICE");
+        if (e_singleDevice) conf.e_singleDevice = std::string(e_singleDevice) == "1";
+        const char* e_virtualSwapchain = std::getenv("LSFG_EXPERIMENTAL_VIRTUAL_SWAPCHAIN");
+        if (e_virtualSwapchain)
+            conf.e_virtualSwapchain = std::string(e_virtualSwapchain) == "1";
+        const char* e_presentThread = std::getenv("LSFG_EXPERIMENTAL_PRESENT_THREAD");
+        if (e_presentThread) conf.e_presentThread = std::string(e_presentThread) == "1";
 
+        // validate the configuration
+        if (conf.maxFramesInFlight > 8)
+            throw std::runtime_error("Max frames in flight cannot be more than 8");
         return conf;
     }
 
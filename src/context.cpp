@@ -1,11 +1,15 @@
 #include "context.hpp"
 #include "config/config.hpp"
 #include "common/exception.hpp"
-#include "extract/extract.hpp"
-#include "extract/trans.hpp"
+#include "extract/batch.hpp"
+#include "mini/counter.hpp"
+#include "utils/latency.hpp"
+#include "utils/pacing.hpp"
+#include "utils/prewarm.hpp"
 #include "utils/utils.hpp"
 #include "hooks.hpp"
 #include "layer.hpp"
+#include "swapchain.hpp"
 
 #include <vulkan/vulkan_core.h>
 #include <lsfg_3_1.hpp>
@@ -13,167 +17,435 @@
 
 #include <filesystem>
 #include <exception>
+#include <atomic>
 #include <iostream>
 #include <cstdint>
 #include <cstdlib>
 #include <vector>
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
+#include <algorithm>
 #include <array>
+#include <cmath>
 
-LsContext::LsContext(const Hooks::DeviceInfo& info, VkSwapchainKHR swapchain,
-        VkExtent2D extent, const std::vector<VkImage>& swapchainImages)
-        : swapchain(swapchain), swapchainImages(swapchainImages),
-          extent(extent) {
-    // get updated configuration
+namespace {
+    /// Serializes access to LSFG, as contexts are built on worker threads.
+    std::mutex lsfgMutex;
+    /// Device LSFG was last initialized on in single-device mode.
+    VkDevice sharedDevice{VK_NULL_HANDLE};
+    /// Incremented whenever LSFG is finalized here, invalidating all context ids.
+    uint64_t lsfgGeneration{0};
+    /// Fraction of a refresh a real frame may overrun before another frame is generated.
+    constexpr double REFRESH_SLACK = 0.1;
+}
+
+bool LsContext::configurationChanged() {
+    const auto& conf = Config::activeConf;
+    return !conf.config_file.empty()
+        && (
+                !std::filesystem::exists(conf.config_file)
+              || conf.timestamp != std::filesystem::last_write_time(conf.config_file)
+        );
+}
+
+void LsContext::updateConfiguration(const Hooks::DeviceInfo& info) {
     auto& conf = Config::activeConf;
-    if (!conf.config_file.empty()
-            && (
-                    !std::filesystem::exists(conf.config_file)
-                  || conf.timestamp != std::filesystem::last_write_time(conf.config_file)
-            )) {
-        std::cerr << "lsfg-vk: Rereading configuration, as it is no longer valid.\n";
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        // reread configuration
-        const std::string file = Utils::getConfigFile();
-        const auto name = Utils::getProcessName();
-        try {
-            Config::updateConfig(file);
-            conf = Config::getConfig(name);
-        } catch (const std::exception& e) {
-            std::cerr << "lsfg-vk: Failed to update configuration, continuing using old:\n";
-            std::cerr << "- " << e.what() << '\n';
-        }
+    if (!configurationChanged())
+        return;
 
-        LSFG_3_1P::finalize();
-        LSFG_3_1::finalize();
+    // finish pre-warming before touching lsfg, pending contexts are dropped by the caller
+    Prewarm::wait(info);
+    const std::scoped_lock lock(lsfgMutex);
 
-        // print config
-        std::cerr << "lsfg-vk: Reloaded configuration for " << name.second << ":\n";
-        if (!conf.dll.empty()) std::cerr << "  Using DLL from: " << conf.dll << '\n';
-        std::cerr << "  Multiplier: " << conf.multiplier << '\n';
-        std::cerr << "  Flow Scale: " << conf.flowScale << '\n';
-        std::cerr << "  Performance Mode: " << (conf.performance ? "Enabled" : "Disabled") << '\n';
-        std::cerr << "  HDR Mode: " << (conf.hdr ? "Enabled" : "Disabled") << '\n';
-        if (conf.e_present != 2) std::cerr << "  ! Present Mode: " << conf.e_present << '\n';
+    std::cerr << "lsfg-vk: Rereading configuration, as it is no longer valid.\n";
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-        if (conf.multiplier <= 1) return;
+    // reread configuration
+    const std::string file = Utils::getConfigFile();
+    const auto name = Utils::getProcessName();
+    try {
+        Config::updateConfig(file);
+        conf = Config::getConfig(name);
+    } catch (const std::exception& e) {
+        std::cerr << "lsfg-vk: Failed to update configuration, continuing using old:\n";
+        std::cerr << "- " << e.what() << '\n';
     }
-    // we could take the format from the swapchain,
-    // but honestly this is safer.
+
+    LSFG_3_1P::finalize();
+    LSFG_3_1::finalize();
+    lsfgGeneration++;
+
+    // print config
+    std::cerr << "lsfg-vk: Reloaded configuration for " << name.second << ":\n";
+    if (!conf.dll.empty()) std::cerr << "  Using DLL from: " << conf.dll << '\n';
+    std::cerr << "  Multiplier: " << conf.multiplier << '\n';
+    std::cerr << "  Flow Scale: " << conf.flowScale << '\n';
+    std::cerr << "  Performance Mode: " << (conf.performance ? "Enabled" : "Disabled") << '\n';
+    std::cerr << "  HDR Mode: " << (conf.hdr ? "Enabled" : "Disabled") << '\n';
+    if (conf.pipelined) std::cerr << "  Pipelined Mode: Enabled\n";
+    if (conf.multiQueue) std::cerr << "  Multi Queue Mode: Enabled\n";
+    if (conf.pacing) std::cerr << "  Frame Pacing: Enabled\n";
+    if (conf.maxFramesInFlight > 0)
+        std::cerr << "  Max Frames In Flight: " << conf.maxFramesInFlight << '\n';
+    if (conf.targetFps > 0) std::cerr << "  Target FPS: " << conf.targetFps << '\n';
+    if (conf.e_present != 2) std::cerr << "  ! Present Mode: " << conf.e_present << '\n';
+    if (conf.e_singleDevice) std::cerr << "  ! Single Device: Enabled\n";
+    if (conf.e_virtualSwapchain) std::cerr << "  ! Virtual Swapchain: Enabled\n";
+    if (conf.e_presentThread) std::cerr << "  ! Present Thread: Enabled\n";
+}
+
+LsContext::LsContext(const Hooks::DeviceInfo& info, VkSwapchainKHR swapchain,
+        VkExtent2D extent, VkFormat swapchainFormat, const std::vector<VkImage>& swapchainImages,
+        std::shared_ptr<VirtualSwapchain> virtualSwapchain)
+        : swapchain(swapchain), swapchainImages(swapchainImages),
+          extent(extent), virtualSwapchain(std::move(virtualSwapchain)) {
+    // finish pre-warming before touching lsfg
+    Prewarm::wait(info);
+    const std::scoped_lock lock(lsfgMutex);
+
+    const auto& conf = Config::activeConf;
+    if (conf.multiplier <= 1) return;
+
+    // the virtual swapchain is driven from the game's thread only, and the game's queue
+    // calls only serialize with the presenter if it was enabled when the device was created
+    this->threaded = conf.e_presentThread && info.queueLocks && !this->virtualSwapchain;
+
+    // we could take the output format from the swapchain,
+    // but honestly this is safer. inputs are only sampled, so they keep the swapchain
+    // format, which turns the input copy into a plain copy and narrows the mipmap read.
     const VkFormat format = conf.hdr
         ? VK_FORMAT_R8G8B8A8_UNORM
         : VK_FORMAT_R16G16B16A16_SFLOAT;
 
-    // prepare textures for lsfg
-    std::array<int, 2> fds{};
-    this->frame_0 = Mini::Image(info.device, info.physicalDevice,
-        extent, format, VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
-        &fds.at(0));
-    this->frame_1 = Mini::Image(info.device, info.physicalDevice,
-        extent, format, VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
-        &fds.at(1));
-
-    std::vector<int> outFds(conf.multiplier - 1);
-    for (size_t i = 0; i < (conf.multiplier - 1); ++i)
-        this->out_n.emplace_back(info.device, info.physicalDevice,
-            extent, format,
-            VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
-            &outFds.at(i));
-
-    // initialize lsfg
-    auto* lsfgInitialize = LSFG_3_1::initialize;
-    auto* lsfgCreateContext = LSFG_3_1::createContext;
     auto* lsfgDeleteContext = LSFG_3_1::deleteContext;
-    if (conf.performance) {
-        lsfgInitialize = LSFG_3_1P::initialize;
-        lsfgCreateContext = LSFG_3_1P::createContext;
+    if (conf.performance)
         lsfgDeleteContext = LSFG_3_1P::deleteContext;
-    }
 
-    setenv("DISABLE_LSFG", "1", 1); // NOLINT
+    int32_t ctxId{};
+    if (info.singleDevice) {
+        // lsfg samples and writes the shared textures directly, no exporting needed
+        const VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        this->frame_0 = Mini::Image(info.device, info.physicalDevice,
+            extent, swapchainFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_ASPECT_COLOR_BIT, nullptr);
+        this->frame_1 = Mini::Image(info.device, info.physicalDevice,
+            extent, swapchainFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_ASPECT_COLOR_BIT, nullptr);
+
+        std::vector<VkImage> outImages;
+        for (size_t i = 0; i < (conf.multiplier - 1); ++i)
+            outImages.push_back(this->out_n.emplace_back(info.device, info.physicalDevice,
+                extent, format,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT | usage, VK_IMAGE_ASPECT_COLOR_BIT,
+                nullptr).handle());
 
-    lsfgInitialize(
-        Utils::getDeviceUUID(info.physicalDevice),
-        conf.hdr, 1.0F / conf.flowScale, conf.multiplier - 1,
-        [](const std::string& name) {
-            auto dxbc = Extract::getShader(name);
-            auto spirv = Extract::translateShader(dxbc);
-            return spirv;
+        this->inSemaphore = Mini::Semaphore(info.device, nullptr, true);
+        this->outSemaphore = Mini::Semaphore(info.device, nullptr, true);
+
+        // initialize lsfg on the game's device, dropping any instance on another one
+        auto* lsfgInitialize = LSFG_3_1::initializeShared;
+        auto* lsfgCreateContext = LSFG_3_1::createSharedContext;
+        if (conf.performance) {
+            lsfgInitialize = LSFG_3_1P::initializeShared;
+            lsfgCreateContext = LSFG_3_1P::createSharedContext;
+        }
+        if (sharedDevice != info.device) {
+            LSFG_3_1P::finalize();
+            LSFG_3_1::finalize();
+            lsfgGeneration++;
+            sharedDevice = info.device;
         }
-    );
 
+        VkPhysicalDeviceProperties properties;
+        Layer::ovkGetPhysicalDeviceProperties(info.physicalDevice, &properties);
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        Layer::ovkGetPhysicalDeviceMemoryProperties(info.physicalDevice, &memoryProperties);
+
+        lsfgInitialize(
+            info.physicalDevice, info.device, info.queue.first, info.queue.second,
+            properties, memoryProperties,
+            conf.hdr, 1.0F / conf.flowScale, conf.multiplier - 1, conf.targetFps > 0,
+            conf.pacing && conf.e_presentThread,
+            Extract::createShaderLoader(conf.performance),
+            Utils::getCacheDirectory()
+        );
+        ctxId = lsfgCreateContext(this->frame_0.handle(), this->frame_1.handle(),
+            outImages, extent, format, swapchainFormat,
+            this->inSemaphore.handle(), this->outSemaphore.handle());
+    } else {
+        // prepare textures for lsfg, or share the images the game renders into
+        std::array<int, 2> fds{};
+        if (this->virtualSwapchain) {
+            fds = this->virtualSwapchain->takeFds();
+        } else {
+            this->frame_0 = Mini::Image(info.device, info.physicalDevice,
+                extent, swapchainFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_IMAGE_ASPECT_COLOR_BIT, &fds.at(0));
+            this->frame_1 = Mini::Image(info.device, info.physicalDevice,
+                extent, swapchainFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_IMAGE_ASPECT_COLOR_BIT, &fds.at(1));
+        }
+        if (fds.at(0) < 0 || fds.at(1) < 0)
+            throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
+                "Virtual swapchain images are already in use");
+
+        std::vector<int> outFds(conf.multiplier - 1);
+        for (size_t i = 0; i < (conf.multiplier - 1); ++i)
+            this->out_n.emplace_back(info.device, info.physicalDevice,
+                extent, format,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
+                &outFds.at(i));
+
+        int inSemaphoreFd{};
+        int outSemaphoreFd{};
+        this->inSemaphore = Mini::Semaphore(info.device, &inSemaphoreFd, true);
+        this->outSemaphore = Mini::Semaphore(info.device, &outSemaphoreFd, true);
+
+        // initialize lsfg
+        auto* lsfgInitialize = LSFG_3_1::initialize;
+        auto* lsfgCreateContext = LSFG_3_1::createContext;
+        if (conf.performance) {
+            lsfgInitialize = LSFG_3_1P::initialize;
+            lsfgCreateContext = LSFG_3_1P::createContext;
+        }
+
+        // keep the layer out of the instance and device lsfg creates on this thread
+        {
+            const Layer::Bypass bypass;
+            lsfgInitialize(
+                Utils::getDeviceUUID(info.physicalDevice),
+                conf.hdr, 1.0F / conf.flowScale, conf.multiplier - 1, conf.targetFps > 0,
+                conf.pacing && conf.e_presentThread, conf.multiQueue, conf.pipelined,
+                Extract::createShaderLoader(conf.performance),
+                Utils::getCacheDirectory()
+            );
+        }
+        ctxId = lsfgCreateContext(fds.at(0), fds.at(1), outFds, extent, format, swapchainFormat,
+            inSemaphoreFd, outSemaphoreFd);
+    }
+
+    // a context dropped while it was being built may outlive a reload, along with its id
     this->lsfgCtxId = std::shared_ptr<int32_t>(
-        new int32_t(lsfgCreateContext(fds.at(0), fds.at(1), outFds, extent, format)),
-        [lsfgDeleteContext = lsfgDeleteContext](const int32_t* id) {
-            lsfgDeleteContext(*id);
+        new int32_t(ctxId),
+        [lsfgDeleteContext = lsfgDeleteContext, generation = lsfgGeneration](const int32_t* id) {
+            const std::scoped_lock lock(lsfgMutex);
+            if (generation == lsfgGeneration)
+                lsfgDeleteContext(*id);
         }
     );
-
-    unsetenv("DISABLE_LSFG"); // NOLINT
+    this->cmdPool = Mini::CommandPool(info.device, info.queue.first);
 
     // prepare render passes
-    this->cmdPool = Mini::CommandPool(info.device, info.queue.first);
     for (size_t i = 0; i < 8; i++) {
         auto& pass = this->passInfos.at(i);
-        pass.renderSemaphores.resize(conf.multiplier - 1);
-        pass.acquireSemaphores.resize(conf.multiplier - 1);
-        pass.postCopyBufs.resize(conf.multiplier - 1);
-        pass.postCopySemaphores.resize(conf.multiplier - 1);
-        pass.prevPostCopySemaphores.resize(conf.multiplier - 1);
+        for (size_t j = 0; j < (conf.multiplier - 1); j++) {
+            pass.acquireSemaphores.emplace_back(info.device);
+            pass.postCopySemaphores.emplace_back(info.device);
+            pass.prevPostCopySemaphores.emplace_back(info.device);
+        }
+        pass.copySemaphore = Mini::Semaphore(info.device);
+    }
+}
+
+void LsContext::recordCopies(const Hooks::DeviceInfo& info) {
+    if (!this->lsfgCtxId)
+        return;
+
+    // record copy commands once, they are identical every frame. on a single device,
+    // the shared textures stay in the layout lsfg accesses them in.
+    const VkImageLayout restingLayout = info.singleDevice
+        ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    const size_t imageCount = this->swapchainImages.size();
+    for (size_t i = 0; i < (this->virtualSwapchain ? 0 : imageCount * 2); i++) {
+        auto& buf = this->preCopyBufs.emplace_back(info.device, this->cmdPool);
+        buf.begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+        Utils::copyImage(buf.handle(),
+            this->swapchainImages.at(i / 2),
+            i % 2 == 0 ? this->frame_0.handle() : this->frame_1.handle(),
+            this->extent.width, this->extent.height,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            true, false, restingLayout, true);
+        buf.end();
+    }
+    for (size_t i = 0; i < this->out_n.size() * imageCount; i++) {
+        auto& buf = this->postCopyBufs.emplace_back(info.device, this->cmdPool);
+        buf.begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+        Utils::copyImage(buf.handle(),
+            this->out_n.at(i / imageCount).handle(),
+            this->swapchainImages.at(i % imageCount),
+            this->extent.width, this->extent.height,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            false, true, restingLayout);
+        buf.end();
     }
 }
 
 VkResult LsContext::present(const Hooks::DeviceInfo& info, const void* pNext, VkQueue queue,
         const std::vector<VkSemaphore>& gameRenderSemaphores, uint32_t presentIdx) {
     const auto& conf = Config::activeConf;
-    auto& pass = this->passInfos.at(this->frameIdx % 8);
-
-    // 1. copy swapchain image to frame_0/frame_1
-    int preCopySemaphoreFd{};
-    pass.preCopySemaphores.at(0) = Mini::Semaphore(info.device, &preCopySemaphoreFd);
-    pass.preCopySemaphores.at(1) = Mini::Semaphore(info.device);
-    pass.preCopyBuf = Mini::CommandBuffer(info.device, this->cmdPool);
-    pass.preCopyBuf.begin();
-
-    Utils::copyImage(pass.preCopyBuf.handle(),
-        this->swapchainImages.at(presentIdx),
-        this->frameIdx % 2 == 0 ? this->frame_0.handle() : this->frame_1.handle(),
-        this->extent.width, this->extent.height,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-        true, false);
-
-    pass.preCopyBuf.end();
-
-    std::vector<VkSemaphore> gameRenderSemaphores2 = gameRenderSemaphores;
-    if (this->frameIdx > 0)
-        gameRenderSemaphores2.emplace_back(this->passInfos.at((this->frameIdx - 1) % 8)
-            .preCopySemaphores.at(1).handle());
-    pass.preCopyBuf.submit(info.queue.second,
-        gameRenderSemaphores2,
-        { pass.preCopySemaphores.at(0).handle(),
-          pass.preCopySemaphores.at(1).handle() });
-
-    // 2. render intermediary frames
-    std::vector<int> renderSemaphoreFds(conf.multiplier - 1);
-    for (size_t i = 0; i < (conf.multiplier - 1); ++i)
-        pass.renderSemaphores.at(i) = Mini::Semaphore(info.device, &renderSemaphoreFds.at(i));
+    Mini::takeObjectCount(); // only count what this call creates on this thread
 
-    if (conf.performance)
-        LSFG_3_1P::presentContext(*this->lsfgCtxId,
-            preCopySemaphoreFd,
-            renderSemaphoreFds);
-    else
-        LSFG_3_1::presentContext(*this->lsfgCtxId,
-            preCopySemaphoreFd,
-            renderSemaphoreFds);
-
-    for (size_t i = 0; i < (conf.multiplier - 1); i++) {
+    // surface errors from presents of earlier frames
+    if (this->presenter) {
+        std::exception_ptr error;
+        {
+            const std::scoped_lock lock(this->presenter->errorMutex);
+            std::swap(error, this->presenter->error);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    std::vector<uint64_t> gameRenderValues(gameRenderSemaphores.size()); // ignored for binary
+    if (this->virtualSwapchain) {
+        // lsfg expects frame fc in frame_(fc % 2), so skip a frame if the game got out of step
+        if (presentIdx != this->frameIdx % 2)
+            return this->virtualSwapchain->present(info, pNext, queue,
+                gameRenderSemaphores, gameRenderValues, presentIdx);
+
+        // 1. hand the virtual image to lsfg once the game is done rendering
+        Utils::forwardSemaphores(info.queue.second,
+            gameRenderSemaphores, gameRenderValues,
+            { this->inSemaphore.handle() }, { this->frameIdx + 1 });
+    } else {
+        // 1. copy swapchain image to frame_0/frame_1
+        std::vector<VkSemaphore> gameRenderSemaphores2 = gameRenderSemaphores;
+        if (this->frameIdx > 0) {
+            gameRenderSemaphores2.emplace_back(this->inSemaphore.handle());
+            gameRenderValues.emplace_back(this->frameIdx);
+        }
+        this->preCopyBufs.at(presentIdx * 2 + this->frameIdx % 2).submit(info.queue.second,
+            gameRenderSemaphores2, gameRenderValues,
+            { this->inSemaphore.handle() }, {{ this->frameIdx + 1 }});
+    }
+
+    // 2. render intermediary frames, with a target only as many as needed to fill the refreshes
+    // until the next real frame. lsfg may run more passes, so present as many as it generates.
+    uint64_t passCount = conf.multiplier - 1;
+    const bool paced = conf.pacing && this->threaded && !pNext; // see presentFrames
+    if (conf.targetFps > 0 || conf.pacing)
+        this->frameRate.beginFrame();
+    const auto interval = this->frameRate.getInterval();
+    if (conf.targetFps > 0) {
+        if (interval.count() > 0) {
+            const double refreshes = std::chrono::duration<double>(interval).count()
+                * static_cast<double>(conf.targetFps);
+            const auto presents = static_cast<uint64_t>(
+                std::max(1.0, std::ceil(refreshes - REFRESH_SLACK)));
+            passCount = std::min(passCount, presents - 1);
+        }
+    }
+
+    // with frame pacing, place each generated frame at the time it will be shown. presents are
+    // spaced over the estimated interval, while the frames they sit between were lastDelta apart.
+    this->timestamps.clear();
+    const auto lastDelta = this->frameRate.getLastDelta();
+    if (paced && interval.count() > 0 && lastDelta.count() > 0) {
+        const double spacing = std::chrono::duration<double>(interval).count()
+            / std::chrono::duration<double>(lastDelta).count()
+            / static_cast<double>(passCount + 1);
+        for (uint64_t i = 0; i < passCount; i++)
+            this->timestamps.push_back(static_cast<float>(
+                std::min(static_cast<double>(i + 1) * spacing, 1.0)));
+    }
+    {
+        const std::scoped_lock lock(lsfgMutex);
+        if (conf.performance)
+            passCount = LSFG_3_1P::presentContext(*this->lsfgCtxId, passCount, this->timestamps);
+        else
+            passCount = LSFG_3_1::presentContext(*this->lsfgCtxId, passCount, this->timestamps);
+    }
+
+    // hand the rest to the presenter thread, unless pNext would not outlive this call
+    VkResult res{};
+    if (this->threaded && !pNext) {
+        if (!this->presenter) {
+            this->presenter = std::make_unique<Presenter>();
+            this->presenter->thread = std::thread([this, presenter = this->presenter.get()]() {
+                while (true) {
+                    const auto request = presenter->requests.pop();
+                    if (request.stop)
+                        break;
+
+                    try {
+                        presenter->result.store(this->presentFrames(request.info, nullptr,
+                            request.queue, request.frameIdx, request.presentIdx,
+                            request.passCount, Config::activeConf.pacing));
+                    } catch (...) {
+                        const std::scoped_lock lock(presenter->errorMutex);
+                        if (!presenter->error)
+                            presenter->error = std::current_exception();
+                    }
+                    presenter->done.fetch_add(1, std::memory_order_release);
+                    presenter->done.notify_all();
+                }
+            });
+        }
+
+        res = this->presenter->result.load();
+        this->presenter->queued++;
+        this->presenter->requests.push({
+            .info = info,
+            .queue = queue,
+            .frameIdx = this->frameIdx,
+            .presentIdx = presentIdx,
+            .passCount = passCount,
+            .stop = false
+        });
+    } else {
+        this->waitIdle();
+        res = this->presentFrames(info, pNext, queue, this->frameIdx, presentIdx, passCount,
+            false);
+    }
+
+    // all objects are created up front, anything else is a regression
+    const size_t created = Mini::takeObjectCount();
+    if (created > 0)
+        Utils::logLimitN("frameObjects", 5,
+            "Created " + std::to_string(created) + " Vulkan objects while presenting");
+
+    // hold the game back until frame generation catches up
+    if (conf.maxFramesInFlight > 0)
+        this->limiter.limit(this->outSemaphore, this->frameIdx,
+            conf.multiplier - 1, conf.maxFramesInFlight);
+
+    this->frameIdx++;
+    return res;
+}
+
+void LsContext::waitIdle() noexcept {
+    if (!this->presenter)
+        return;
+
+    const uint64_t queued = this->presenter->queued;
+    uint64_t done = this->presenter->done.load(std::memory_order_acquire);
+    while (done < queued) {
+        this->presenter->done.wait(done, std::memory_order_acquire);
+        done = this->presenter->done.load(std::memory_order_acquire);
+    }
+}
+
+LsContext::Presenter::~Presenter() {
+    this->requests.push({ .stop = true });
+    if (this->thread.joinable())
+        this->thread.join();
+}
+
+VkResult LsContext::presentFrames(const Hooks::DeviceInfo& info, const void* pNext,
+        VkQueue queue, uint64_t frame, uint32_t presentIdx, uint64_t passCount, bool paced) {
+    const auto& conf = Config::activeConf;
+    auto& pass = this->passInfos.at(frame % 8);
+    // sleeping on the game's thread would hold its next frame back, which then
+    // lengthens the measured interval, so only the presenter thread paces
+    if (paced)
+        this->pacing.beginFrame();
+
+    for (size_t i = 0; i < passCount; i++) {
         // 3. acquire next swapchain image
-        pass.acquireSemaphores.at(i) = Mini::Semaphore(info.device);
         uint32_t imageIdx{};
         auto res = Layer::ovkAcquireNextImageKHR(info.device, this->swapchain, UINT64_MAX,
             pass.acquireSemaphores.at(i).handle(), VK_NULL_HANDLE, &imageIdx);
@@ -181,28 +453,18 @@ VkResult LsContext::present(const Hooks::DeviceInfo& info, const void* pNext, Vk
             throw LSFG::vulkan_error(res, "Failed to acquire next swapchain image");
 
         // 4. copy output image to swapchain image
-        pass.postCopySemaphores.at(i) = Mini::Semaphore(info.device);
-        pass.prevPostCopySemaphores.at(i) = Mini::Semaphore(info.device);
-        pass.postCopyBufs.at(i) = Mini::CommandBuffer(info.device, this->cmdPool);
-        pass.postCopyBufs.at(i).begin();
-
-        Utils::copyImage(pass.postCopyBufs.at(i).handle(),
-            this->out_n.at(i).handle(),
-            this->swapchainImages.at(imageIdx),
-            this->extent.width, this->extent.height,
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-            false, true);
-
-        pass.postCopyBufs.at(i).end();
-        pass.postCopyBufs.at(i).submit(info.queue.second,
+        this->postCopyBufs.at(i * this->swapchainImages.size() + imageIdx).submit(info.queue.second,
             { pass.acquireSemaphores.at(i).handle(),
-              pass.renderSemaphores.at(i).handle() },
+              this->outSemaphore.handle() },
+            {{ 0, frame * (conf.multiplier - 1) + i + 1 }},
             { pass.postCopySemaphores.at(i).handle(),
               pass.prevPostCopySemaphores.at(i).handle() });
 
-        // 5. present swapchain image
+        // 5. present swapchain image, spaced out over the frame interval
         std::vector<VkSemaphore> waitSemaphores{ pass.postCopySemaphores.at(i).handle() };
         if (i != 0) waitSemaphores.emplace_back(pass.prevPostCopySemaphores.at(i - 1).handle());
+        if (paced)
+            this->pacing.waitFor(i, passCount + 1);
 
         const VkPresentInfoKHR presentInfo{
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -219,20 +481,45 @@ VkResult LsContext::present(const Hooks::DeviceInfo& info, const void* pNext, Vk
     }
 
     // 6. present actual next frame
-    VkSemaphore lastPrevPostCopySemaphore =
-        pass.prevPostCopySemaphores.at(conf.multiplier - 1 - 1).handle();
-    const VkPresentInfoKHR presentInfo{
-        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &lastPrevPostCopySemaphore,
-        .swapchainCount = 1,
-        .pSwapchains = &this->swapchain,
-        .pImageIndices = &presentIdx,
-    };
-    auto res = Layer::ovkQueuePresentKHR(queue, &presentInfo);
-    if (res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR)
-        throw LSFG::vulkan_error(res, "Failed to present swapchain image");
+    if (paced)
+        this->pacing.waitFor(passCount, passCount + 1);
+    VkResult res{};
+    if (this->virtualSwapchain) {
+        std::vector<VkSemaphore> waitSemaphores{ this->inSemaphore.handle() };
+        std::vector<uint64_t> waitValues{ frame + 1 };
+        if (passCount > 0) {
+            waitSemaphores.emplace_back(pass.prevPostCopySemaphores.at(passCount - 1).handle());
+            waitValues.emplace_back(0);
+        }
+        res = this->virtualSwapchain->present(info, nullptr, queue,
+            waitSemaphores, waitValues, presentIdx);
+
+        // both shared images are read until this frame is generated, the next
+        // frame moves the release of the current one further out
+        const uint64_t generated = (frame + 1) * (conf.multiplier - 1);
+        this->virtualSwapchain->release(0, this->outSemaphore.handle(), generated);
+        this->virtualSwapchain->release(1, this->outSemaphore.handle(), generated);
+    } else {
+        // without generated frames, only the copy out of the swapchain image has to finish
+        VkSemaphore lastSemaphore = pass.copySemaphore.handle();
+        if (passCount > 0)
+            lastSemaphore = pass.prevPostCopySemaphores.at(passCount - 1).handle();
+        else
+            Utils::forwardSemaphores(info.queue.second,
+                { this->inSemaphore.handle() }, { frame + 1 }, { lastSemaphore }, { 0 });
+
+        const VkPresentInfoKHR presentInfo{
+            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &lastSemaphore,
+            .swapchainCount = 1,
+            .pSwapchains = &this->swapchain,
+            .pImageIndices = &presentIdx,
+        };
+        res = Layer::ovkQueuePresentKHR(queue, &presentInfo);
+        if (res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR)
+            throw LSFG::vulkan_error(res, "Failed to present swapchain image");
+    }
 
-    this->frameIdx++;
     return res;
 }
@@ -0,0 +1,125 @@
+#include "extract/batch.hpp"
+#include "extract/extract.hpp"
+#include "extract/cache.hpp"
+
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <span>
+
+using namespace Extract;
+
+std::unordered_map<std::string, std::vector<uint8_t>> Extract::translateShaders(bool performance) {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto names = getShaderNames(performance);
+
+    // several names alias the same resource, translate each resource only once
+    std::vector<std::span<const uint8_t>> resources;
+    std::vector<std::string> labels;
+    std::vector<size_t> nameToResource(names.size());
+    std::unordered_map<const uint8_t*, size_t> resourceIndices;
+    for (size_t i = 0; i < names.size(); i++) {
+        const auto dxbc = getShader(names.at(i));
+        auto [it, inserted] = resourceIndices.try_emplace(dxbc.data(), resources.size());
+        if (inserted) {
+            resources.push_back(dxbc);
+            labels.push_back(names.at(i));
+        } else {
+            labels.at(it->second) += ", " + names.at(i);
+        }
+        nameToResource.at(i) = it->second;
+    }
+
+    std::vector<std::vector<uint8_t>> results(resources.size());
+    std::vector<std::chrono::microseconds> durations(resources.size());
+    std::vector<std::exception_ptr> errors(resources.size());
+
+    // translate shaders on a pool of workers, counting cache hits of this batch only
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < resources.size(); i = next++) {
+            const auto shaderStart = std::chrono::high_resolution_clock::now();
+            try {
+                bool hit{};
+                results.at(i) = translateShaderCached(resources.at(i), &hit);
+                (hit ? hits : misses)++;
+            } catch (...) {
+                errors.at(i) = std::current_exception();
+            }
+            durations.at(i) = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - shaderStart);
+        }
+    };
+
+    const size_t workerCount = std::clamp<size_t>(
+        std::thread::hardware_concurrency(), 1, std::max<size_t>(resources.size(), 1));
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount - 1);
+    for (size_t i = 1; i < workerCount; i++)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers)
+        thread.join();
+
+    for (const auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    // report timings
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start);
+    if (misses > 0)
+        for (size_t i = 0; i < resources.size(); i++)
+            std::cerr << "lsfg-vk:   " << labels.at(i) << ": "
+                      << std::setprecision(2) << std::fixed
+                      << static_cast<float>(durations.at(i).count()) / 1000.0F << " ms\n";
+    std::cerr << "lsfg-vk: Prepared " << resources.size() << " unique shaders on "
+              << workerCount << " threads in "
+              << std::setprecision(2) << std::fixed
+              << static_cast<float>(total.count()) / 1000.0F << " ms ("
+              << hits.load() << " cache hits, " << misses.load() << " misses)\n";
+
+    std::unordered_map<std::string, std::vector<uint8_t>> shaders;
+    for (size_t i = 0; i < names.size(); i++)
+        shaders.emplace(names.at(i), results.at(nameToResource.at(i)));
+    return shaders;
+}
+
+std::function<std::vector<uint8_t>(const std::string&)> Extract::createShaderLoader(bool performance) {
+    struct LoaderState {
+        bool translated{false};
+        std::unordered_map<std::string, std::vector<uint8_t>> shaders;
+    };
+    auto state = std::make_shared<LoaderState>();
+
+    return [state, performance](const std::string& name) {
+        if (!state->translated) {
+            state->shaders = translateShaders(performance);
+            state->translated = true;
+        }
+
+        // hand out each batched shader once, then fall back to the cache
+        auto it = state->shaders.find(name);
+        if (it != state->shaders.end()) {
+            auto spirv = std::move(it->second);
+            state->shaders.erase(it);
+            return spirv;
+        }
+        return translateShaderCached(getShader(name));
+    };
+}
@@ -0,0 +1,148 @@
+#include "extract/cache.hpp"
+#include "extract/strip.hpp"
+#include "extract/trans.hpp"
+#include "utils/utils.hpp"
+
+#include <unistd.h>
+
+#include <system_error>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <span>
+#include <array>
+#include <ios>
+
+using namespace Extract;
+
+namespace {
+    /// Version of the translator output. Bump whenever translateShader or stripShader changes.
+    constexpr uint32_t TRANSLATOR_VERSION = 2;
+    /// Magic number at the start of every cache entry ("LSVC").
+    constexpr uint32_t CACHE_MAGIC = 0x4356534C;
+
+    /// Header of a cache entry, followed by the SPIR-V bytecode.
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t hash;
+        uint64_t dxbcSize;
+        uint64_t spirvSize;
+    };
+
+    /// 64-bit FNV-1a hash of the DXBC bytecode, seeded with the translator version.
+    uint64_t hashBytecode(std::span<const uint8_t> bytecode) {
+        uint64_t hash = 0xCBF29CE484222325ULL ^ TRANSLATOR_VERSION;
+        for (const uint8_t byte : bytecode) {
+            hash ^= byte;
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    std::filesystem::path getEntryPath(uint64_t hash) {
+        std::array<char, 17> name{};
+        snprintf(name.data(), name.size(), "%016llx", // NOLINT
+            static_cast<unsigned long long>(hash));
+        return std::filesystem::path(Utils::getCacheDirectory())
+            / ("spirv-v" + std::to_string(TRANSLATOR_VERSION))
+            / (std::string(name.data()) + ".spv");
+    }
+
+    std::optional<std::vector<uint8_t>> loadEntry(const std::filesystem::path& path,
+            uint64_t hash, size_t dxbcSize) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return std::nullopt;
+
+        CacheHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file.good()
+                || header.magic != CACHE_MAGIC
+                || header.version != TRANSLATOR_VERSION
+                || header.hash != hash
+                || header.dxbcSize != dxbcSize
+                || header.spirvSize == 0 || header.spirvSize % 4 != 0)
+            return std::nullopt;
+
+        std::vector<uint8_t> spirv(header.spirvSize);
+        file.read(reinterpret_cast<char*>(spirv.data()),
+            static_cast<std::streamsize>(spirv.size()));
+        if (!file.good())
+            return std::nullopt;
+        return spirv;
+    }
+
+    void storeEntry(const std::filesystem::path& path,
+            uint64_t hash, size_t dxbcSize, const std::vector<uint8_t>& spirv) {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec)
+            return;
+
+        // write to a temporary file first, so concurrent processes never see partial entries
+        std::filesystem::path tmpPath = path;
+        tmpPath += ".tmp" + std::to_string(getpid());
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return;
+
+            const CacheHeader header{
+                .magic = CACHE_MAGIC,
+                .version = TRANSLATOR_VERSION,
+                .hash = hash,
+                .dxbcSize = dxbcSize,
+                .spirvSize = spirv.size()
+            };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(spirv.data()),
+                static_cast<std::streamsize>(spirv.size()));
+            if (!file.good()) {
+                file.close();
+                std::filesystem::remove(tmpPath, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+            std::filesystem::remove(tmpPath, ec);
+    }
+
+    void storeEntryOrWarn(const std::filesystem::path& path,
+            uint64_t hash, size_t dxbcSize, const std::vector<uint8_t>& spirv) {
+        try {
+            storeEntry(path, hash, dxbcSize, spirv);
+        } catch (const std::exception& e) {
+            std::cerr << "lsfg-vk: Unable to write shader cache entry, ignoring:\n";
+            std::cerr << "- " << e.what() << '\n';
+        }
+    }
+}
+
+std::vector<uint8_t> Extract::translateShaderCached(std::span<const uint8_t> bytecode,
+        bool* hit) {
+    const uint64_t hash = hashBytecode(bytecode);
+    const auto path = getEntryPath(hash);
+
+    // try the cache first
+    auto cached = loadEntry(path, hash, bytecode.size());
+    if (hit)
+        *hit = cached.has_value();
+    if (cached.has_value())
+        return std::move(*cached);
+
+    // translate, strip and store the result
+    auto spirv = stripShader(translateShader(bytecode));
+    storeEntryOrWarn(path, hash, bytecode.size(), spirv);
+    return spirv;
+}
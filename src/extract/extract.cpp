@@ -2,8 +2,13 @@
 #include "config/config.hpp"
 
 #include <pe-parse/parse.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <cstdlib>
+#include <exception>
 #include <filesystem>
 #include <algorithm>
 #include <cstdint>
@@ -11,6 +16,8 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <mutex>
+#include <span>
 
 using namespace Extract;
 
@@ -70,20 +77,48 @@ const std::unordered_map<std::string, uint32_t> nameIdxTable = {{
 }};
 
 namespace {
+    std::mutex extractMutex;
+    bool extracted{false};
+    std::exception_ptr failure; // error of the first extraction, rethrown instead of retrying
+
     auto& shaders() {
-        static std::unordered_map<uint32_t, std::vector<uint8_t>> shaderData;
+        static std::unordered_map<uint32_t, std::span<const uint8_t>> shaderData;
         return shaderData;
     }
 
     int on_resource(void*, const peparse::resource& res) {
         if (res.type != peparse::RT_RCDATA || res.buf == nullptr || res.buf->bufLen <= 0)
             return 0;
-        std::vector<uint8_t> resource_data(res.buf->bufLen);
-        std::copy_n(res.buf->buf, res.buf->bufLen, resource_data.data());
-        shaders()[res.name] = resource_data;
+        // only index resources that are actually referenced
+        const bool used = std::ranges::any_of(nameIdxTable,
+            [&res](const auto& entry) { return entry.second == res.name; });
+        if (!used)
+            return 0;
+        shaders()[res.name] = std::span<const uint8_t>(res.buf->buf, res.buf->bufLen);
         return 0;
     }
 
+    /// Map the dll into memory. The mapping is kept alive for the process lifetime.
+    std::span<uint8_t> mapDll(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT
+        if (fd < 0)
+            throw std::runtime_error("Unable to read Lossless.dll, is it installed?");
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            close(fd);
+            throw std::runtime_error("Unable to read Lossless.dll, is it installed?");
+        }
+
+        const auto size = static_cast<size_t>(st.st_size);
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Unable to map Lossless.dll into memory");
+
+        return { static_cast<uint8_t*>(data), size };
+    }
+
     const std::vector<std::filesystem::path> PATHS{{
         ".local/share/Steam/steamapps/common",
         ".steam/steam/steamapps/common",
@@ -92,11 +127,10 @@ namespace {
         "snap/steam/common/.local/share/Steam/steamapps/common"
     }};
 
-    std::string getDllPath() {
+    std::string getDllPath(const std::string& dll) {
         // overriden path
-        std::string dllPath = Config::activeConf.dll;
-        if (!dllPath.empty())
-            return dllPath;
+        if (!dll.empty())
+            return dll;
         // home based paths
         const char* home = getenv("HOME");
         const std::string homeStr = home ? home : "";
@@ -115,26 +149,40 @@ namespace {
     }
 }
 
-void Extract::extractShaders() {
-    if (!shaders().empty())
+void Extract::extractShaders(const std::string& dll) {
+    const std::scoped_lock lock(extractMutex);
+    if (extracted)
         return;
+    if (failure)
+        std::rethrow_exception(failure);
 
-    // parse the dll
-    peparse::parsed_pe* dll = peparse::ParsePEFromFile(getDllPath().c_str());
-    if (!dll)
-        throw std::runtime_error("Unable to read Lossless.dll, is it installed?");
-    peparse::IterRsrc(dll, on_resource, nullptr);
-    peparse::DestructParsedPE(dll);
+    // map and parse the dll
+    std::span<uint8_t> mapping;
+    try {
+        mapping = mapDll(getDllPath(dll));
+        peparse::parsed_pe* dll = peparse::ParsePEFromPointer(mapping.data(),
+            static_cast<uint32_t>(mapping.size()));
+        if (!dll)
+            throw std::runtime_error("Unable to parse Lossless.dll, is it corrupted?");
+        peparse::IterRsrc(dll, on_resource, nullptr);
+        peparse::DestructParsedPE(dll);
 
-    // ensure all shaders are present
-    for (const auto& [name, idx] : nameIdxTable)
-        if (shaders().find(idx) == shaders().end())
-            throw std::runtime_error("Shader not found: " + name + ".\n- Is Lossless Scaling up to date?");
+        // ensure all shaders are present
+        for (const auto& [name, idx] : nameIdxTable)
+            if (shaders().find(idx) == shaders().end())
+                throw std::runtime_error("Shader not found: " + name + ".\n- Is Lossless Scaling up to date?");
+    } catch (const std::exception&) {
+        shaders().clear();
+        if (!mapping.empty())
+            munmap(mapping.data(), mapping.size());
+        failure = std::current_exception();
+        throw;
+    }
+    extracted = true;
 }
 
-std::vector<uint8_t> Extract::getShader(const std::string& name) {
-    if (shaders().empty())
-        throw std::runtime_error("Shaders are not loaded.");
+std::span<const uint8_t> Extract::getShader(const std::string& name) {
+    extractShaders(Config::activeConf.dll); // joins a running extraction
 
     auto hit = nameIdxTable.find(name);
     if (hit == nameIdxTable.end())
@@ -146,3 +194,11 @@ std::vector<uint8_t> Extract::getShader(const std::string& name) {
 
     return sit->second;
 }
+
+std::vector<std::string> Extract::getShaderNames(bool performance) {
+    std::vector<std::string> names;
+    for (const auto& [name, idx] : nameIdxTable)
+        if (name.starts_with("p_") == performance)
+            names.push_back(name);
+    return names;
+}
@@ -0,0 +1,73 @@
+#include "extract/strip.hpp"
+
+#include <spirv/unified1/spirv.hpp>
+
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <span>
+
+using namespace Extract;
+
+namespace {
+    /// Whether an instruction only carries debug information.
+    bool isDebugInstruction(uint32_t opCode) {
+        switch (opCode) {
+            case spv::OpNop:
+            case spv::OpSourceContinued:
+            case spv::OpSource:
+            case spv::OpSourceExtension:
+            case spv::OpName:
+            case spv::OpMemberName:
+            case spv::OpString:
+            case spv::OpLine:
+            case spv::OpNoLine:
+            case spv::OpModuleProcessed:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// Split a word into opcode and word count, validating the length.
+    std::pair<uint32_t, size_t> decode(const std::vector<uint32_t>& words, size_t offset) {
+        const uint32_t opCode = words.at(offset) & spv::OpCodeMask;
+        const size_t count = words.at(offset) >> spv::WordCountShift;
+        if (count == 0 || offset + count > words.size())
+            throw std::runtime_error("Malformed SPIR-V instruction");
+        return { opCode, count };
+    }
+}
+
+std::vector<uint8_t> Extract::stripShader(std::span<const uint8_t> bytecode) {
+    if (bytecode.size() % 4 != 0 || bytecode.size() < 20)
+        throw std::runtime_error("Malformed SPIR-V module");
+    std::vector<uint32_t> words(bytecode.size() / 4);
+    std::memcpy(words.data(), bytecode.data(), bytecode.size());
+    if (words.at(0) != spv::MagicNumber)
+        throw std::runtime_error("Malformed SPIR-V module");
+
+    // rewrite the module without debug instructions
+    std::vector<uint32_t> result(words.begin(), words.begin() + 5);
+    result.reserve(words.size());
+    for (size_t offset = 5; offset < words.size();) {
+        const auto [opCode, count] = decode(words, offset);
+
+        if (isDebugInstruction(opCode)) {
+            offset += count;
+            continue;
+        }
+
+        result.insert(result.end(),
+            words.begin() + static_cast<std::ptrdiff_t>(offset),
+            words.begin() + static_cast<std::ptrdiff_t>(offset + count));
+        offset += count;
+    }
+
+    std::vector<uint8_t> stripped(result.size() * 4);
+    std::memcpy(stripped.data(), result.data(), stripped.size());
+    return stripped;
+}
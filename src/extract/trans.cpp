@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <algorithm>
 #include <vector>
+#include <span>
 
 using namespace Extract;
 
@@ -20,7 +21,7 @@ struct BindingOffsets {
   uint32_t setOffset{};
 };
 
-std::vector<uint8_t> Extract::translateShader(std::vector<uint8_t> bytecode) {
+std::vector<uint8_t> Extract::translateShader(std::span<const uint8_t> bytecode) {
     // compile the shader
     dxvk::DxbcReader reader(reinterpret_cast<const char*>(bytecode.data()), bytecode.size());
     dxvk::DxbcModule module(reader);
@@ -1,11 +1,16 @@
 #include "hooks.hpp"
 #include "common/exception.hpp"
 #include "config/config.hpp"
+#include "utils/prewarm.hpp"
 #include "utils/utils.hpp"
 #include "context.hpp"
 #include "layer.hpp"
+#include "swapchain.hpp"
 
+#include <vulkan/vk_layer.h>
 #include <vulkan/vulkan_core.h>
+#include <lsfg_3_1.hpp>
+#include <lsfg_3_1p.hpp>
 
 #include <unordered_map>
 #include <filesystem>
@@ -13,15 +18,47 @@
 #include <algorithm>
 #include <exception>
 #include <iostream>
+#include <future>
+#include <chrono>
 #include <cstdint>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
+#include <utility>
 
 using namespace Hooks;
 
 namespace {
 
+    /// Size of a struct that may precede the feature structs in a pNext chain, or 0 if unknown.
+    size_t getStructSize(VkStructureType type) {
+        switch (type) {
+            case VK_STRUCTURE_TYPE_LOADER_DEVICE_CREATE_INFO:
+                return sizeof(VkLayerDeviceCreateInfo);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2:
+                return sizeof(VkPhysicalDeviceFeatures2);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES:
+                return sizeof(VkPhysicalDeviceVulkan11Features);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES:
+                return sizeof(VkPhysicalDeviceVulkan12Features);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES:
+                return sizeof(VkPhysicalDeviceVulkan13Features);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES:
+                return sizeof(VkPhysicalDeviceTimelineSemaphoreFeatures);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES:
+                return sizeof(VkPhysicalDeviceSynchronization2Features);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES:
+                return sizeof(VkPhysicalDeviceVulkanMemoryModelFeatures);
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT:
+                return sizeof(VkPhysicalDeviceRobustness2FeaturesEXT);
+            default:
+                return 0;
+        }
+    }
+
     ///
     /// Add extensions to the instance create info.
     ///
@@ -51,6 +88,8 @@ namespace {
 
     /// Map of devices to related information.
     std::unordered_map<VkDevice, DeviceInfo> deviceToInfo;
+    /// Contexts dropped while being built, destroyed by a reaper once their builder is done.
+    std::vector<std::pair<VkDevice, std::future<void>>> droppedSwapchains;
 
     ///
     /// Add extensions to the device create info.
@@ -61,21 +100,155 @@ namespace {
             const VkDeviceCreateInfo* pCreateInfo,
             const VkAllocationCallbacks* pAllocator,
             VkDevice* pDevice) {
+        // frame generation on the game's device needs everything its own device would enable
+        const bool singleDevice = Config::activeConf.e_singleDevice;
+
         // add extensions
+        std::vector<const char*> requiredExtensions{
+            "VK_KHR_external_memory",
+            "VK_KHR_external_memory_fd",
+            "VK_KHR_external_semaphore",
+            "VK_KHR_external_semaphore_fd",
+            "VK_KHR_timeline_semaphore"
+        };
+        if (singleDevice)
+            requiredExtensions.insert(requiredExtensions.end(), {
+                "VK_KHR_synchronization2",
+                "VK_KHR_vulkan_memory_model",
+                "VK_EXT_robustness2"
+            });
         auto extensions = Utils::addExtensions(
             pCreateInfo->ppEnabledExtensionNames,
             pCreateInfo->enabledExtensionCount,
-            {
-                "VK_KHR_external_memory",
-                "VK_KHR_external_memory_fd",
-                "VK_KHR_external_semaphore",
-                "VK_KHR_external_semaphore_fd"
-            }
+            requiredExtensions
         );
         VkDeviceCreateInfo createInfo = *pCreateInfo;
         createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
         createInfo.ppEnabledExtensionNames = extensions.data();
+
+        // enable required features in the game's feature structs if present. the caller's chain
+        // is const, so it is copied up to the last struct that gets patched | NOLINTBEGIN
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+            .timelineSemaphore = VK_TRUE
+        };
+        VkPhysicalDeviceSynchronization2Features sync2Features{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES,
+            .synchronization2 = VK_TRUE
+        };
+        VkPhysicalDeviceVulkanMemoryModelFeatures memoryModelFeatures{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES,
+            .vulkanMemoryModel = VK_TRUE
+        };
+        VkPhysicalDeviceRobustness2FeaturesEXT robustness2Features{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT,
+            .nullDescriptor = VK_TRUE
+        };
+        const auto isPatched = [singleDevice](VkStructureType type) {
+            switch (type) {
+                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES:
+                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES:
+                    return true;
+                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES:
+                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES:
+                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES:
+                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT:
+                    return singleDevice;
+                default:
+                    return false;
+            }
+        };
+
+        // find the structs up to the last one that gets patched
+        std::vector<const VkBaseInStructure*> prefix;
+        std::vector<const VkBaseInStructure*> entries;
+        for (const auto* entry = reinterpret_cast<const VkBaseInStructure*>(pCreateInfo->pNext);
+                entry; entry = entry->pNext) {
+            entries.push_back(entry);
+            if (isPatched(entry->sType))
+                prefix = entries;
+        }
+        const bool copyable = std::ranges::all_of(prefix,
+            [](const auto* entry) { return getStructSize(entry->sType) != 0; });
+
+        // copy them, keeping the rest of the chain shared. if an unknown struct is in the
+        // way, the game's structs are patched in place and restored after the call instead.
+        std::vector<std::vector<uint64_t>> copies; // 8-byte aligned storage
+        VkBaseOutStructure* previous{};
+        for (const auto* entry : prefix) {
+            const size_t size = getStructSize(entry->sType);
+            if (!copyable && !isPatched(entry->sType))
+                continue;
+            auto& copy = copies.emplace_back((size + 7) / 8);
+            std::memcpy(copy.data(), entry, size);
+            if (!copyable)
+                continue;
+
+            auto* out = reinterpret_cast<VkBaseOutStructure*>(copy.data());
+            if (previous)
+                previous->pNext = out;
+            else
+                createInfo.pNext = out;
+            previous = out;
+        }
+        if (!copyable)
+            Utils::logLimitN("devFeatures", 1,
+                "Unknown struct in the device create chain, patching features temporarily");
+
+        // patch the feature structs of the (copied) chain
+        bool timelineEnabled{false};
+        bool sync2Enabled{!singleDevice};
+        bool memoryModelEnabled{!singleDevice};
+        bool robustness2Enabled{!singleDevice};
+        auto* feature = reinterpret_cast<VkBaseOutStructure*>(const_cast<void*>(createInfo.pNext));
+        for (size_t i = 0; feature && i < prefix.size(); feature = feature->pNext, i++) {
+            if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES) {
+                auto* features12 = reinterpret_cast<VkPhysicalDeviceVulkan12Features*>(feature);
+                features12->timelineSemaphore = VK_TRUE;
+                timelineEnabled = true;
+                if (singleDevice) {
+                    features12->vulkanMemoryModel = VK_TRUE;
+                    memoryModelEnabled = true;
+                }
+            } else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES) {
+                reinterpret_cast<VkPhysicalDeviceTimelineSemaphoreFeatures*>(feature)->timelineSemaphore = VK_TRUE;
+                timelineEnabled = true;
+            } else if (!singleDevice) {
+                continue;
+            } else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES) {
+                reinterpret_cast<VkPhysicalDeviceVulkan13Features*>(feature)->synchronization2 = VK_TRUE;
+                sync2Enabled = true;
+            } else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES) {
+                reinterpret_cast<VkPhysicalDeviceSynchronization2Features*>(feature)->synchronization2 = VK_TRUE;
+                sync2Enabled = true;
+            } else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES) {
+                reinterpret_cast<VkPhysicalDeviceVulkanMemoryModelFeatures*>(feature)->vulkanMemoryModel = VK_TRUE;
+                memoryModelEnabled = true;
+            } else if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT) {
+                reinterpret_cast<VkPhysicalDeviceRobustness2FeaturesEXT*>(feature)->nullDescriptor = VK_TRUE;
+                robustness2Enabled = true;
+            }
+        }
+
+        // chain our own structs for anything the game did not mention
+        const auto chain = [&createInfo](auto& features) {
+            features.pNext = const_cast<void*>(createInfo.pNext);
+            createInfo.pNext = &features;
+        };
+        if (!timelineEnabled) chain(timelineFeatures);
+        if (!sync2Enabled) chain(sync2Features);
+        if (!memoryModelEnabled) chain(memoryModelFeatures);
+        if (!robustness2Enabled) chain(robustness2Features);
+
+        // NOLINTEND | create the device
         auto res = Layer::ovkCreateDevice(physicalDevice, &createInfo, pAllocator, pDevice);
+        if (!copyable) {
+            auto saved = copies.begin();
+            for (const auto* entry : prefix)
+                if (isPatched(entry->sType))
+                    std::memcpy(const_cast<VkBaseInStructure*>(entry), (saved++)->data(), // NOLINT
+                        getStructSize(entry->sType));
+        }
         if (res == VK_ERROR_EXTENSION_NOT_PRESENT)
             throw std::runtime_error(
                 "Required Vulkan device extensions are not present."
@@ -84,30 +257,114 @@ namespace {
     }
 
     ///
-    /// Add related device information after the device is created.
+    /// Add related device information after the device is created
+    /// and start pre-warming the frame generation device.
     ///
     VkResult myvkCreateDevicePost(
             VkPhysicalDevice physicalDevice,
             VkDeviceCreateInfo* pCreateInfo,
             const VkAllocationCallbacks*,
             VkDevice* pDevice) {
-        deviceToInfo.emplace(*pDevice, DeviceInfo {
+        auto [it, _] = deviceToInfo.emplace(*pDevice, DeviceInfo {
             .device = *pDevice,
             .physicalDevice = physicalDevice,
-            .queue = Utils::findQueue(*pDevice, physicalDevice, pCreateInfo, VK_QUEUE_GRAPHICS_BIT)
+            .queue = Utils::findQueue(*pDevice, physicalDevice, pCreateInfo, VK_QUEUE_GRAPHICS_BIT),
+            .singleDevice = Config::activeConf.e_singleDevice,
+            .queueLocks = Config::activeConf.e_presentThread
         });
+        if (!it->second.singleDevice) // nothing to pre-warm before lsfg runs on this device
+            Prewarm::start(it->second);
         return VK_SUCCESS;
     }
 
     /// Erase the device information when the device is destroyed.
     void myvkDestroyDevice(VkDevice device, const VkAllocationCallbacks* pAllocator) noexcept {
+        // dropped contexts still own objects on the device, destroying a future waits for them
+        std::erase_if(droppedSwapchains, [device](const auto& dropped) {
+            return dropped.first == device;
+        });
+
+        auto it = deviceToInfo.find(device);
+        if (it != deviceToInfo.end() && it->second.singleDevice) {
+            // lsfg objects live on this device, so they have to go first
+            LSFG_3_1P::finalize();
+            LSFG_3_1::finalize();
+        }
         deviceToInfo.erase(device);
         Layer::ovkDestroyDevice(device, pAllocator);
     }
 
+    // queue hooks, the original functions serialize with the presenter thread
+
+    VkResult myvkQueueSubmit(
+            VkQueue queue,
+            uint32_t submitCount,
+            const VkSubmitInfo* pSubmits,
+            VkFence fence) noexcept {
+        return Layer::ovkQueueSubmit(queue, submitCount, pSubmits, fence);
+    }
+
+    VkResult myvkQueueSubmit2(
+            VkQueue queue,
+            uint32_t submitCount,
+            const VkSubmitInfo2* pSubmits,
+            VkFence fence) noexcept {
+        return Layer::ovkQueueSubmit2(queue, submitCount, pSubmits, fence);
+    }
+
+    VkResult myvkQueueBindSparse(
+            VkQueue queue,
+            uint32_t bindInfoCount,
+            const VkBindSparseInfo* pBindInfo,
+            VkFence fence) noexcept {
+        return Layer::ovkQueueBindSparse(queue, bindInfoCount, pBindInfo, fence);
+    }
+
+    VkResult myvkQueueWaitIdle(VkQueue queue) noexcept {
+        return Layer::ovkQueueWaitIdle(queue);
+    }
+
+    VkResult myvkDeviceWaitIdle(VkDevice device) noexcept {
+        return Layer::ovkDeviceWaitIdle(device);
+    }
+
     std::unordered_map<VkSwapchainKHR, LsContext> swapchains;
+    std::unordered_map<VkSwapchainKHR, std::future<LsContext>> pendingSwapchains;
     std::unordered_map<VkSwapchainKHR, VkDevice> swapchainToDeviceTable;
     std::unordered_map<VkSwapchainKHR, VkPresentModeKHR> swapchainToPresent;
+    std::unordered_map<VkSwapchainKHR, std::shared_ptr<VirtualSwapchain>> virtualSwapchains;
+
+    ///
+    /// Drop the context of a swapchain that is still being built, without waiting for it.
+    ///
+    void dropPending(VkSwapchainKHR swapchain) {
+        auto it = pendingSwapchains.find(swapchain);
+        if (it == pendingSwapchains.end())
+            return;
+
+        // forget reapers that are done, destroying their futures does not block then
+        std::erase_if(droppedSwapchains, [](const auto& dropped) {
+            return dropped.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+
+        auto device = swapchainToDeviceTable.find(swapchain);
+        try {
+            droppedSwapchains.emplace_back(
+                device != swapchainToDeviceTable.end() ? device->second : VK_NULL_HANDLE,
+                std::async(std::launch::async, [builder = std::move(it->second)]() mutable {
+                    try {
+                        builder.get(); // the context is destroyed right away
+                    } catch (const std::exception&) {
+                        // nobody is interested in the error anymore
+                    }
+                })
+            );
+        } catch (const std::exception& e) {
+            std::cerr << "lsfg-vk: Unable to drop a swapchain context in the background, waiting:\n";
+            std::cerr << "- " << e.what() << '\n';
+        }
+        pendingSwapchains.erase(it);
+    }
 
     ///
     /// Adjust swapchain creation parameters and create a swapchain context.
@@ -155,7 +412,9 @@ namespace {
         // retire potential old swapchain
         if (pCreateInfo->oldSwapchain) {
             swapchains.erase(pCreateInfo->oldSwapchain);
+            dropPending(pCreateInfo->oldSwapchain);
             swapchainToDeviceTable.erase(pCreateInfo->oldSwapchain);
+            virtualSwapchains.erase(pCreateInfo->oldSwapchain);
         }
 
         // create swapchain
@@ -178,15 +437,35 @@ namespace {
             if (res != VK_SUCCESS)
                 throw LSFG::vulkan_error(res, "Failed to get swapchain images");
 
-            // create swapchain context
+            // reloading shuts down lsfg, which invalidates contexts still being built.
+            // drop them first, their swapchains present unmodified until recreated.
+            if (LsContext::configurationChanged())
+                while (!pendingSwapchains.empty())
+                    dropPending(pendingSwapchains.begin()->first);
+            LsContext::updateConfiguration(deviceInfo);
+
+            // let the game render into images shared with lsfg
+            std::shared_ptr<VirtualSwapchain> virtualSwapchain;
+            if (Config::activeConf.e_virtualSwapchain && !deviceInfo.singleDevice
+                    && VirtualSwapchain::isSupported(*pCreateInfo)) {
+                virtualSwapchain = std::make_shared<VirtualSwapchain>(deviceInfo,
+                    *pSwapchain, *pCreateInfo, swapchainImages);
+                virtualSwapchains.emplace(*pSwapchain, virtualSwapchain);
+            }
+
+            // create swapchain context in the background, presenting unmodified until ready
             swapchainToDeviceTable.emplace(*pSwapchain, device);
-            swapchains.emplace(*pSwapchain, LsContext(
-                deviceInfo, *pSwapchain, pCreateInfo->imageExtent,
-                swapchainImages
+            pendingSwapchains.emplace(*pSwapchain, std::async(std::launch::async,
+                [deviceInfo, swapchain = *pSwapchain, extent = pCreateInfo->imageExtent,
+                        format = pCreateInfo->imageFormat,
+                        swapchainImages = std::move(swapchainImages), virtualSwapchain]() {
+                    return LsContext(deviceInfo, swapchain, extent, format, swapchainImages,
+                        virtualSwapchain);
+                }
             ));
 
             std::cerr << "lsfg-vk: Swapchain context " <<
-                    (createInfo.oldSwapchain ? "recreated" : "created")
+                    (createInfo.oldSwapchain ? "recreating" : "creating")
                 << " (using " << imageCount << " images).\n";
 
             Utils::resetLimitN("swapCtxCreate");
@@ -222,12 +501,57 @@ namespace {
         }
         auto& deviceInfo = it2->second;
 
-        // find swapchain context
+        // virtual images have to be copied into the real swapchain even without lsfg
+        auto it5 = virtualSwapchains.find(*pPresentInfo->pSwapchains);
+        const auto presentUnmodified = [&]() -> VkResult {
+            auto it3 = swapchains.find(*pPresentInfo->pSwapchains);
+            if (it3 != swapchains.end())
+                it3->second.waitIdle();
+
+            if (it5 == virtualSwapchains.end())
+                return Layer::ovkQueuePresentKHR(queue, pPresentInfo);
+
+            try {
+                std::vector<VkSemaphore> semaphores(pPresentInfo->waitSemaphoreCount);
+                std::copy_n(pPresentInfo->pWaitSemaphores, semaphores.size(), semaphores.data());
+                return it5->second->present(deviceInfo, pPresentInfo->pNext, queue,
+                    semaphores, std::vector<uint64_t>(semaphores.size()),
+                    *pPresentInfo->pImageIndices);
+            } catch (const std::exception& e) {
+                Utils::logLimitN("swapPresent", 5,
+                    "An error occurred while presenting the virtual swapchain:\n"
+                    "- " + std::string(e.what()));
+                return VK_ERROR_INITIALIZATION_FAILED;
+            }
+        };
+
+        // find swapchain context, switching over once it has been built
         auto it3 = swapchains.find(*pPresentInfo->pSwapchains);
         if (it3 == swapchains.end()) {
-            Utils::logLimitN("swapMap", 5,
-                "Swapchain context not found in map");
-            return Layer::ovkQueuePresentKHR(queue, pPresentInfo);
+            auto pending = pendingSwapchains.find(*pPresentInfo->pSwapchains);
+            if (pending == pendingSwapchains.end()) {
+                Utils::logLimitN("swapMap", 5,
+                    "Swapchain context not found in map");
+                return presentUnmodified();
+            }
+            if (pending->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return presentUnmodified();
+
+            auto builder = std::move(pending->second);
+            pendingSwapchains.erase(pending);
+            try {
+                auto context = builder.get();
+                context.recordCopies(deviceInfo);
+                it3 = swapchains.emplace(*pPresentInfo->pSwapchains, std::move(context)).first;
+
+                std::cerr << "lsfg-vk: Swapchain context ready, enabling frame generation.\n";
+                Utils::resetLimitN("swapCtxCreate");
+            } catch (const std::exception& e) {
+                Utils::logLimitN("swapCtxCreate", 5,
+                    "An error occurred while creating the swapchain wrapper:\n"
+                    "- " + std::string(e.what()));
+                return presentUnmodified();
+            }
         }
         auto& swapchain = it3->second;
 
@@ -236,7 +560,7 @@ namespace {
         if (it4 == swapchainToPresent.end()) {
             Utils::logLimitN("swapMap", 5,
                 "Swapchain present mode not found in map");
-            return Layer::ovkQueuePresentKHR(queue, pPresentInfo);
+            return presentUnmodified();
         }
         auto& present = it4->second;
 
@@ -266,19 +590,19 @@ namespace {
                             !std::filesystem::exists(conf.config_file)
                           || conf.timestamp != std::filesystem::last_write_time(conf.config_file)
                     )) {
-                Layer::ovkQueuePresentKHR(queue, pPresentInfo);
+                presentUnmodified();
                 return VK_ERROR_OUT_OF_DATE_KHR;
             }
 
             // ensure present mode is still valid
             if (present != conf.e_present) {
-                Layer::ovkQueuePresentKHR(queue, pPresentInfo);
+                presentUnmodified();
                 return VK_ERROR_OUT_OF_DATE_KHR;
             }
 
             // skip if disabled
             if (conf.multiplier <= 1)
-                return Layer::ovkQueuePresentKHR(queue, pPresentInfo);
+                return presentUnmodified();
 
             // present the swapchain
             std::vector<VkSemaphore> semaphores(pPresentInfo->waitSemaphoreCount);
@@ -297,14 +621,77 @@ namespace {
         return res;
     }
 
+    /// Return the virtual images in place of the real ones.
+    VkResult myvkGetSwapchainImagesKHR(
+            VkDevice device,
+            VkSwapchainKHR swapchain,
+            uint32_t* pSwapchainImageCount,
+            VkImage* pSwapchainImages) noexcept {
+        auto it = virtualSwapchains.find(swapchain);
+        if (it == virtualSwapchains.end())
+            return Layer::ovkGetSwapchainImagesKHR(device, swapchain,
+                pSwapchainImageCount, pSwapchainImages);
+
+        const auto& images = it->second->getImages();
+        if (!pSwapchainImages) {
+            *pSwapchainImageCount = static_cast<uint32_t>(images.size());
+            return VK_SUCCESS;
+        }
+
+        const size_t count = std::min<size_t>(*pSwapchainImageCount, images.size());
+        std::copy_n(images.data(), count, pSwapchainImages);
+        *pSwapchainImageCount = static_cast<uint32_t>(count);
+        return count < images.size() ? VK_INCOMPLETE : VK_SUCCESS;
+    }
+
+    /// Acquire a virtual image without touching the real swapchain.
+    VkResult myvkAcquireNextImageKHR(
+            VkDevice device,
+            VkSwapchainKHR swapchain,
+            uint64_t timeout,
+            VkSemaphore semaphore,
+            VkFence fence,
+            uint32_t* pImageIndex) noexcept {
+        auto it = virtualSwapchains.find(swapchain);
+        if (it == virtualSwapchains.end()) {
+            // the presenter thread owns the swapchain until it is done
+            auto it3 = swapchains.find(swapchain);
+            if (it3 != swapchains.end())
+                it3->second.waitIdle();
+
+            return Layer::ovkAcquireNextImageKHR(device, swapchain, timeout,
+                semaphore, fence, pImageIndex);
+        }
+
+        auto it2 = deviceToInfo.find(device);
+        if (it2 == deviceToInfo.end()) {
+            Utils::logLimitN("swapMap", 5,
+                "Device not found in map");
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        try {
+            *pImageIndex = it->second->acquire(it2->second, semaphore, fence);
+            Utils::resetLimitN("swapAcquire");
+        } catch (const std::exception& e) {
+            Utils::logLimitN("swapAcquire", 5,
+                "An error occurred while acquiring a virtual image:\n"
+                "- " + std::string(e.what()));
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        return VK_SUCCESS;
+    }
+
     /// Erase the swapchain context and mapping when the swapchain is destroyed.
     void myvkDestroySwapchainKHR(
             VkDevice device,
             VkSwapchainKHR swapchain,
             const VkAllocationCallbacks* pAllocator) noexcept {
         swapchains.erase(swapchain);
+        dropPending(swapchain);
         swapchainToDeviceTable.erase(swapchain);
         swapchainToPresent.erase(swapchain);
+        virtualSwapchains.erase(swapchain);
         Layer::ovkDestroySwapchainKHR(device, swapchain, pAllocator);
     }
 }
@@ -320,6 +707,17 @@ std::unordered_map<std::string, PFN_vkVoidFunction> Hooks::hooks = {
 
     // swapchain hooks
     {"vkCreateSwapchainKHR", reinterpret_cast<PFN_vkVoidFunction>(myvkCreateSwapchainKHR)},
+    {"vkGetSwapchainImagesKHR", reinterpret_cast<PFN_vkVoidFunction>(myvkGetSwapchainImagesKHR)},
+    {"vkAcquireNextImageKHR", reinterpret_cast<PFN_vkVoidFunction>(myvkAcquireNextImageKHR)},
     {"vkQueuePresentKHR", reinterpret_cast<PFN_vkVoidFunction>(myvkQueuePresentKHR)},
     {"vkDestroySwapchainKHR", reinterpret_cast<PFN_vkVoidFunction>(myvkDestroySwapchainKHR)}
 };
+
+std::unordered_map<std::string, PFN_vkVoidFunction> Hooks::queueHooks = {
+    {"vkQueueSubmit", reinterpret_cast<PFN_vkVoidFunction>(myvkQueueSubmit)},
+    {"vkQueueSubmit2", reinterpret_cast<PFN_vkVoidFunction>(myvkQueueSubmit2)},
+    {"vkQueueSubmit2KHR", reinterpret_cast<PFN_vkVoidFunction>(myvkQueueSubmit2)},
+    {"vkQueueBindSparse", reinterpret_cast<PFN_vkVoidFunction>(myvkQueueBindSparse)},
+    {"vkQueueWaitIdle", reinterpret_cast<PFN_vkVoidFunction>(myvkQueueWaitIdle)},
+    {"vkDeviceWaitIdle", reinterpret_cast<PFN_vkVoidFunction>(myvkDeviceWaitIdle)}
+};
@@ -1,6 +1,7 @@
 #include "layer.hpp"
 #include "common/exception.hpp"
 #include "config/config.hpp"
+#include "utils/utils.hpp"
 #include "hooks.hpp"
 
 #include <vulkan/vk_layer.h>
@@ -11,6 +12,7 @@
 #include <iostream>
 #include <cstdint>
 #include <string>
+#include <mutex>
 
 namespace {
     PFN_vkCreateInstance  next_vkCreateInstance{};
@@ -49,12 +51,40 @@ namespace {
     PFN_vkDestroySemaphore next_vkDestroySemaphore{};
     PFN_vkGetMemoryFdKHR next_vkGetMemoryFdKHR{};
     PFN_vkGetSemaphoreFdKHR next_vkGetSemaphoreFdKHR{};
+    PFN_vkWaitSemaphoresKHR next_vkWaitSemaphoresKHR{};
+    PFN_vkGetSemaphoreCounterValueKHR next_vkGetSemaphoreCounterValueKHR{};
     PFN_vkGetDeviceQueue next_vkGetDeviceQueue{};
     PFN_vkQueueSubmit next_vkQueueSubmit{};
+    PFN_vkQueueSubmit2 next_vkQueueSubmit2{};
+    PFN_vkQueueBindSparse next_vkQueueBindSparse{};
+    PFN_vkQueueWaitIdle next_vkQueueWaitIdle{};
+    PFN_vkDeviceWaitIdle next_vkDeviceWaitIdle{};
     PFN_vkCmdPipelineBarrier next_vkCmdPipelineBarrier{};
     PFN_vkCmdBlitImage next_vkCmdBlitImage{};
+    PFN_vkCmdCopyImage next_vkCmdCopyImage{};
     PFN_vkAcquireNextImageKHR next_vkAcquireNextImageKHR{};
 
+    // instances and devices created while bypassed, with their next layer's entry points
+    thread_local bool bypassed{false};
+    std::mutex bypassMutex;
+    std::unordered_map<VkInstance, PFN_vkGetInstanceProcAddr> bypassedInstances;
+    std::unordered_map<VkPhysicalDevice, VkInstance> bypassedPhysicalDevices;
+    std::unordered_map<VkDevice, PFN_vkGetDeviceProcAddr> bypassedDevices;
+
+    /// Find the next layer's vkGetInstanceProcAddr of a bypassed instance.
+    PFN_vkGetInstanceProcAddr getBypassed(VkInstance instance) {
+        const std::scoped_lock lock(bypassMutex);
+        auto it = bypassedInstances.find(instance);
+        return it != bypassedInstances.end() ? it->second : nullptr;
+    }
+
+    /// Find the next layer's vkGetDeviceProcAddr of a bypassed device.
+    PFN_vkGetDeviceProcAddr getBypassed(VkDevice device) {
+        const std::scoped_lock lock(bypassMutex);
+        auto it = bypassedDevices.find(device);
+        return it != bypassedDevices.end() ? it->second : nullptr;
+    }
+
     template<typename T>
     bool initInstanceFunc(VkInstance instance, const char* name, T* func) {
         *func = reinterpret_cast<T>(next_vkGetInstanceProcAddr(instance, name));
@@ -94,9 +124,25 @@ namespace {
                 throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
                     "No layer creation info found in pNext chain");
 
-            next_vkGetInstanceProcAddr = layerDesc->u.pLayerInfo->pfnNextGetInstanceProcAddr;
+            auto* nextGetInstanceProcAddr = layerDesc->u.pLayerInfo->pfnNextGetInstanceProcAddr;
             layerDesc->u.pLayerInfo = layerDesc->u.pLayerInfo->pNext;
 
+            // pass through without touching the game's function pointers
+            if (bypassed) {
+                auto* createInstance = reinterpret_cast<PFN_vkCreateInstance>(
+                    nextGetInstanceProcAddr(nullptr, "vkCreateInstance"));
+                if (!createInstance)
+                    throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
+                        "Failed to get instance function pointer for vkCreateInstance");
+                auto res = createInstance(pCreateInfo, pAllocator, pInstance);
+                if (res == VK_SUCCESS) {
+                    const std::scoped_lock lock(bypassMutex);
+                    bypassedInstances.emplace(*pInstance, nextGetInstanceProcAddr);
+                }
+                return res;
+            }
+            next_vkGetInstanceProcAddr = nextGetInstanceProcAddr;
+
             bool success = initInstanceFunc(nullptr, "vkCreateInstance", &next_vkCreateInstance);
             if (!success)
                 throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
@@ -165,9 +211,35 @@ namespace {
                 throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
                     "No layer creation info found in pNext chain");
 
-            next_vkGetDeviceProcAddr = layerDesc->u.pLayerInfo->pfnNextGetDeviceProcAddr;
+            auto* nextGetDeviceProcAddr = layerDesc->u.pLayerInfo->pfnNextGetDeviceProcAddr;
             layerDesc->u.pLayerInfo = layerDesc->u.pLayerInfo->pNext;
 
+            // pass through without touching the game's function pointers
+            if (bypassed) {
+                VkInstance instance{};
+                {
+                    const std::scoped_lock lock(bypassMutex);
+                    auto it = bypassedPhysicalDevices.find(physicalDevice);
+                    if (it == bypassedPhysicalDevices.end())
+                        throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
+                            "Physical device was not enumerated from a bypassed instance");
+                    instance = it->second;
+                }
+                auto* getProcAddr = getBypassed(instance);
+                auto* createDevice = getProcAddr ? reinterpret_cast<PFN_vkCreateDevice>(
+                    getProcAddr(instance, "vkCreateDevice")) : nullptr;
+                if (!createDevice)
+                    throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
+                        "Failed to get instance function pointer for vkCreateDevice");
+                auto res = createDevice(physicalDevice, pCreateInfo, pAllocator, pDevice);
+                if (res == VK_SUCCESS) {
+                    const std::scoped_lock lock(bypassMutex);
+                    bypassedDevices.emplace(*pDevice, nextGetDeviceProcAddr);
+                }
+                return res;
+            }
+            next_vkGetDeviceProcAddr = nextGetDeviceProcAddr;
+
             auto* layerDesc2 = const_cast<VkLayerDeviceCreateInfo*>(
                 reinterpret_cast<const VkLayerDeviceCreateInfo*>(pCreateInfo->pNext));
             while (layerDesc2 && (layerDesc2->sType != VK_STRUCTURE_TYPE_LOADER_DEVICE_CREATE_INFO
@@ -219,15 +291,28 @@ namespace {
             success &= initDeviceFunc(*pDevice, "vkCreateSemaphore", &next_vkCreateSemaphore);
             success &= initDeviceFunc(*pDevice, "vkDestroySemaphore", &next_vkDestroySemaphore);
             success &= initDeviceFunc(*pDevice, "vkGetSemaphoreFdKHR", &next_vkGetSemaphoreFdKHR);
+            success &= initDeviceFunc(*pDevice, "vkWaitSemaphoresKHR", &next_vkWaitSemaphoresKHR);
+            success &= initDeviceFunc(*pDevice, "vkGetSemaphoreCounterValueKHR", &next_vkGetSemaphoreCounterValueKHR);
             success &= initDeviceFunc(*pDevice, "vkGetDeviceQueue", &next_vkGetDeviceQueue);
             success &= initDeviceFunc(*pDevice, "vkQueueSubmit", &next_vkQueueSubmit);
+            success &= initDeviceFunc(*pDevice, "vkQueueBindSparse", &next_vkQueueBindSparse);
+            success &= initDeviceFunc(*pDevice, "vkQueueWaitIdle", &next_vkQueueWaitIdle);
+            success &= initDeviceFunc(*pDevice, "vkDeviceWaitIdle", &next_vkDeviceWaitIdle);
             success &= initDeviceFunc(*pDevice, "vkCmdPipelineBarrier", &next_vkCmdPipelineBarrier);
             success &= initDeviceFunc(*pDevice, "vkCmdBlitImage", &next_vkCmdBlitImage);
+            success &= initDeviceFunc(*pDevice, "vkCmdCopyImage", &next_vkCmdCopyImage);
             success &= initDeviceFunc(*pDevice, "vkAcquireNextImageKHR", &next_vkAcquireNextImageKHR);
             if (!success)
                 throw LSFG::vulkan_error(VK_ERROR_INITIALIZATION_FAILED,
                     "Failed to get device function pointers");
 
+            // only present with Vulkan 1.3 or synchronization2, the game cannot call it otherwise
+            next_vkQueueSubmit2 = reinterpret_cast<PFN_vkQueueSubmit2>(
+                next_vkGetDeviceProcAddr(*pDevice, "vkQueueSubmit2"));
+            if (!next_vkQueueSubmit2)
+                next_vkQueueSubmit2 = reinterpret_cast<PFN_vkQueueSubmit2>(
+                    next_vkGetDeviceProcAddr(*pDevice, "vkQueueSubmit2KHR"));
+
             auto postCreateDeviceHook = reinterpret_cast<PFN_vkCreateDevice>(
                 Hooks::hooks["vkCreateDevicePost"]);
             auto res = postCreateDeviceHook(physicalDevice, pCreateInfo, pAllocator, pDevice);
@@ -242,6 +327,65 @@ namespace {
         }
         return VK_SUCCESS;
     } // NOLINTEND
+
+    VkResult layer_vkEnumerateBypassedPhysicalDevices(
+            VkInstance instance,
+            uint32_t* pPhysicalDeviceCount,
+            VkPhysicalDevice* pPhysicalDevices) {
+        auto* getProcAddr = getBypassed(instance);
+        if (!getProcAddr)
+            return VK_ERROR_INITIALIZATION_FAILED;
+        auto* enumeratePhysicalDevices = reinterpret_cast<PFN_vkEnumeratePhysicalDevices>(
+            getProcAddr(instance, "vkEnumeratePhysicalDevices"));
+        auto res = enumeratePhysicalDevices(instance, pPhysicalDeviceCount, pPhysicalDevices);
+        if (pPhysicalDevices && (res == VK_SUCCESS || res == VK_INCOMPLETE)) {
+            // remember the instance so vkCreateDevice can be resolved through it
+            const std::scoped_lock lock(bypassMutex);
+            for (uint32_t i = 0; i < *pPhysicalDeviceCount; i++)
+                bypassedPhysicalDevices[pPhysicalDevices[i]] = instance;
+        }
+        return res;
+    }
+
+    void layer_vkDestroyBypassedInstance(
+            VkInstance instance,
+            const VkAllocationCallbacks* pAllocator) {
+        auto* getProcAddr = getBypassed(instance);
+        if (!getProcAddr)
+            return;
+        auto* destroyInstance = reinterpret_cast<PFN_vkDestroyInstance>(
+            getProcAddr(instance, "vkDestroyInstance"));
+        {
+            const std::scoped_lock lock(bypassMutex);
+            bypassedInstances.erase(instance);
+            std::erase_if(bypassedPhysicalDevices,
+                [instance](const auto& entry) { return entry.second == instance; });
+        }
+        destroyInstance(instance, pAllocator);
+    }
+
+    void layer_vkDestroyBypassedDevice(
+            VkDevice device,
+            const VkAllocationCallbacks* pAllocator) {
+        auto* getProcAddr = getBypassed(device);
+        if (!getProcAddr)
+            return;
+        auto* destroyDevice = reinterpret_cast<PFN_vkDestroyDevice>(
+            getProcAddr(device, "vkDestroyDevice"));
+        {
+            const std::scoped_lock lock(bypassMutex);
+            bypassedDevices.erase(device);
+        }
+        destroyDevice(device, pAllocator);
+    }
+}
+
+Layer::Bypass::Bypass() noexcept : previous(bypassed) {
+    bypassed = true;
+}
+
+Layer::Bypass::~Bypass() {
+    bypassed = this->previous;
 }
 
 const std::unordered_map<std::string, PFN_vkVoidFunction> layerFunctions = {
@@ -261,6 +405,14 @@ PFN_vkVoidFunction layer_vkGetInstanceProcAddr(VkInstance instance, const char*
     if (it != layerFunctions.end())
         return it->second;
 
+    if (auto* getProcAddr = instance ? getBypassed(instance) : nullptr) {
+        if (name == "vkEnumeratePhysicalDevices")
+            return reinterpret_cast<PFN_vkVoidFunction>(&layer_vkEnumerateBypassedPhysicalDevices);
+        if (name == "vkDestroyInstance")
+            return reinterpret_cast<PFN_vkVoidFunction>(&layer_vkDestroyBypassedInstance);
+        return getProcAddr(instance, pName);
+    }
+
     it = Hooks::hooks.find(name);
     if (it != Hooks::hooks.end() && Config::activeConf.enable)
         return it->second;
@@ -274,6 +426,21 @@ PFN_vkVoidFunction layer_vkGetDeviceProcAddr(VkDevice device, const char* pName)
     if (it != layerFunctions.end())
         return it->second;
 
+    if (auto* getProcAddr = getBypassed(device)) {
+        if (name == "vkDestroyDevice")
+            return reinterpret_cast<PFN_vkVoidFunction>(&layer_vkDestroyBypassedDevice);
+        return getProcAddr(device, pName);
+    }
+
+    // queue hooks are only needed by the presenter thread, and only if the driver has them
+    it = Hooks::queueHooks.find(name);
+    if (it != Hooks::queueHooks.end()) {
+        auto* next = next_vkGetDeviceProcAddr(device, pName);
+        if (next && Config::activeConf.enable && Config::activeConf.e_presentThread)
+            return it->second;
+        return next;
+    }
+
     it = Hooks::hooks.find(name);
     if (it != Hooks::hooks.end() && Config::activeConf.enable)
         return it->second;
@@ -356,6 +523,7 @@ namespace Layer {
     VkResult ovkQueuePresentKHR(
             VkQueue queue,
             const VkPresentInfoKHR* pPresentInfo) {
+        const auto lock = Utils::lockQueue(queue);
         return next_vkQueuePresentKHR(queue, pPresentInfo);
     }
     void ovkDestroySwapchainKHR(
@@ -479,6 +647,18 @@ namespace Layer {
             int* pFd) {
         return next_vkGetSemaphoreFdKHR(device, pGetFdInfo, pFd);
     }
+    VkResult ovkWaitSemaphores(
+            VkDevice device,
+            const VkSemaphoreWaitInfo* pWaitInfo,
+            uint64_t timeout) {
+        return next_vkWaitSemaphoresKHR(device, pWaitInfo, timeout);
+    }
+    VkResult ovkGetSemaphoreCounterValue(
+            VkDevice device,
+            VkSemaphore semaphore,
+            uint64_t* pValue) {
+        return next_vkGetSemaphoreCounterValueKHR(device, semaphore, pValue);
+    }
 
     void ovkGetDeviceQueue(
             VkDevice device,
@@ -492,8 +672,38 @@ namespace Layer {
             uint32_t submitCount,
             const VkSubmitInfo* pSubmits,
             VkFence fence) {
+        const auto lock = Utils::lockQueue(queue);
         return next_vkQueueSubmit(queue, submitCount, pSubmits, fence);
     }
+    VkResult ovkQueueSubmit2(
+            VkQueue queue,
+            uint32_t submitCount,
+            const VkSubmitInfo2* pSubmits,
+            VkFence fence) {
+        if (!next_vkQueueSubmit2)
+            return VK_ERROR_INITIALIZATION_FAILED;
+
+        const auto lock = Utils::lockQueue(queue);
+        return next_vkQueueSubmit2(queue, submitCount, pSubmits, fence);
+    }
+    VkResult ovkQueueBindSparse(
+            VkQueue queue,
+            uint32_t bindInfoCount,
+            const VkBindSparseInfo* pBindInfo,
+            VkFence fence) {
+        const auto lock = Utils::lockQueue(queue);
+        return next_vkQueueBindSparse(queue, bindInfoCount, pBindInfo, fence);
+    }
+    VkResult ovkQueueWaitIdle(
+            VkQueue queue) {
+        const auto lock = Utils::lockQueue(queue);
+        return next_vkQueueWaitIdle(queue);
+    }
+    VkResult ovkDeviceWaitIdle(
+            VkDevice device) {
+        const auto locks = Utils::lockAllQueues();
+        return next_vkDeviceWaitIdle(device);
+    }
 
     void ovkCmdPipelineBarrier(
             VkCommandBuffer commandBuffer,
@@ -522,6 +732,16 @@ namespace Layer {
             VkFilter filter) {
         next_vkCmdBlitImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout, regionCount, pRegions, filter);
     }
+    void ovkCmdCopyImage(
+            VkCommandBuffer commandBuffer,
+            VkImage srcImage,
+            VkImageLayout srcImageLayout,
+            VkImage dstImage,
+            VkImageLayout dstImageLayout,
+            uint32_t regionCount,
+            const VkImageCopy* pRegions) {
+        next_vkCmdCopyImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout, regionCount, pRegions);
+    }
 
     VkResult ovkAcquireNextImageKHR(
             VkDevice device,
@@ -5,6 +5,7 @@
 #include "utils/utils.hpp"
 
 #include <unistd.h>
+#include <dlfcn.h>
 
 #include <exception>
 #include <fstream>
@@ -16,11 +17,25 @@
 #include <thread>
 
 namespace {
+    /// Keep the layer loaded for the process lifetime, as background threads run its code.
+    void pinLibrary() {
+        Dl_info info{};
+        if (!dladdr(reinterpret_cast<void*>(&pinLibrary), &info) || !info.dli_fname)
+            return;
+        dlopen(info.dli_fname, RTLD_NOW | RTLD_NOLOAD | RTLD_NODELETE);
+    }
+
     __attribute__((constructor)) void lsfgvk_init() {
         std::cerr << std::unitbuf;
 
-        // read configuration
+        // skip parsing entirely if no game entry can match this process
         const std::string file = Utils::getConfigFile();
+        const auto name = Utils::getProcessName();
+        if (!std::getenv("LSFG_LEGACY") && name.second != "benchmark"
+                && !Config::mayMatchGame(file, name))
+            return; // default configuration will unload
+
+        // read configuration
         try {
             Config::updateConfig(file);
         } catch (const std::exception& e) {
@@ -29,7 +44,6 @@ namespace {
             return; // default configuration will unload
         }
 
-        const auto name = Utils::getProcessName();
         try {
             Config::activeConf = Config::getConfig(name);
         } catch (const std::exception& e) {
@@ -46,11 +60,20 @@ namespace {
         // print config
         std::cerr << "lsfg-vk: Loaded configuration for " << name.second << ":\n";
         if (!conf.dll.empty()) std::cerr << "  Using DLL from: " << conf.dll << '\n';
-        std::cerr << "  Multiplier: " << conf.multiplier << '\n';
+            std::cerr << "  Multiplier: " << conf.multiplier << '\n';
         std::cerr << "  Flow Scale: " << conf.flowScale << '\n';
         std::cerr << "  Performance Mode: " << (conf.performance ? "Enabled" : "Disabled") << '\n';
         std::cerr << "  HDR Mode: " << (conf.hdr ? "Enabled" : "Disabled") << '\n';
+        if (conf.pipelined) std::cerr << "  Pipelined Mode: Enabled\n";
+        if (conf.multiQueue) std::cerr << "  Multi Queue Mode: Enabled\n";
+        if (conf.pacing) std::cerr << "  Frame Pacing: Enabled\n";
+        if (conf.maxFramesInFlight > 0)
+            std::cerr << "  Max Frames In Flight: " << conf.maxFramesInFlight << '\n';
+        if (conf.targetFps > 0) std::cerr << "  Target FPS: " << conf.targetFps << '\n';
         if (conf.e_present != 2) std::cerr << "  ! Present Mode: " << conf.e_present << '\n';
+        if (conf.e_singleDevice) std::cerr << "  ! Single Device: Enabled\n";
+        if (conf.e_virtualSwapchain) std::cerr << "  ! Virtual Swapchain: Enabled\n";
+        if (conf.e_presentThread) std::cerr << "  ! Present Thread: Enabled\n";
 
         // remove mesa var in favor of config
         unsetenv("MESA_VK_WSI_PRESENT_MODE"); // NOLINT
@@ -71,15 +94,20 @@ namespace {
             Utils::showErrorGui(e.what());
         }
 
-        // load shaders
-        try {
-            Extract::extractShaders();
-        } catch (const std::exception& e) {
-            std::cerr << "lsfg-vk: An error occurred while trying to extract the shaders, exiting:\n";
-            std::cerr << "- " << e.what() << '\n';
-            Utils::showErrorGui(e.what());
-        }
-        std::cerr << "lsfg-vk: Shaders extracted successfully.\n";
+        // load shaders in the background, they are only needed once a swapchain exists.
+        // failures are kept and reported again when a swapchain context needs the shaders.
+        // the dll path is copied, as the configuration may be reloaded meanwhile.
+        pinLibrary();
+        std::thread extraction([dll = conf.dll]() {
+            try {
+                Extract::extractShaders(dll);
+                std::cerr << "lsfg-vk: Shaders extracted successfully.\n";
+            } catch (const std::exception& e) {
+                std::cerr << "lsfg-vk: An error occurred while trying to extract the shaders:\n";
+                std::cerr << "- " << e.what() << '\n';
+            }
+        });
+        extraction.detach();
 
         // run benchmark if requested
         const char* benchmark_flag = std::getenv("LSFG_BENCHMARK");
@@ -1,11 +1,13 @@
 #include "mini/commandbuffer.hpp"
 #include "mini/commandpool.hpp"
+#include "mini/counter.hpp"
 #include "common/exception.hpp"
 #include "layer.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
+#include <optional>
 #include <memory>
 #include <stdexcept>
 #include <vector>
@@ -28,8 +30,11 @@ CommandBuffer::CommandBuffer(VkDevice device, const CommandPool& pool) {
     if (res != VK_SUCCESS)
         throw LSFG::vulkan_error(res, "Unable to set device loader data for command buffer");
 
+    countObject();
+
     // store command buffer in shared ptr
     this->state = std::make_shared<CommandBufferState>(CommandBufferState::Empty);
+    this->usage = std::make_shared<VkCommandBufferUsageFlags>(0);
     this->commandBuffer = std::shared_ptr<VkCommandBuffer>(
         new VkCommandBuffer(commandBufferHandle),
         [dev = device, pool = pool.handle()](VkCommandBuffer* cmdBuffer) {
@@ -38,18 +43,19 @@ CommandBuffer::CommandBuffer(VkDevice device, const CommandPool& pool) {
     );
 }
 
-void CommandBuffer::begin() {
+void CommandBuffer::begin(VkCommandBufferUsageFlags usage) {
     if (*this->state != CommandBufferState::Empty)
         throw std::logic_error("Command buffer is not in Empty state");
 
     const VkCommandBufferBeginInfo beginInfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        .flags = usage
     };
     auto res = Layer::ovkBeginCommandBuffer(*this->commandBuffer, &beginInfo);
     if (res != VK_SUCCESS)
         throw LSFG::vulkan_error(res, "Unable to begin command buffer");
 
+    *this->usage = usage;
     *this->state = CommandBufferState::Recording;
 }
 
@@ -66,15 +72,32 @@ void CommandBuffer::end() {
 
 void CommandBuffer::submit(VkQueue queue,
         const std::vector<VkSemaphore>& waitSemaphores,
-        const std::vector<VkSemaphore>& signalSemaphores) {
+        std::optional<std::vector<uint64_t>> waitSemaphoreValues,
+        const std::vector<VkSemaphore>& signalSemaphores,
+        std::optional<std::vector<uint64_t>> signalSemaphoreValues) {
     if (*this->state != CommandBufferState::Full)
         throw std::logic_error("Command buffer is not in Full state");
 
     const std::vector<VkPipelineStageFlags> waitStages(waitSemaphores.size(),
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+    VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+    };
+    if (waitSemaphoreValues.has_value()) {
+        timelineInfo.waitSemaphoreValueCount =
+            static_cast<uint32_t>(waitSemaphoreValues->size());
+        timelineInfo.pWaitSemaphoreValues = waitSemaphoreValues->data();
+    }
+    if (signalSemaphoreValues.has_value()) {
+        timelineInfo.signalSemaphoreValueCount =
+            static_cast<uint32_t>(signalSemaphoreValues->size());
+        timelineInfo.pSignalSemaphoreValues = signalSemaphoreValues->data();
+    }
 
     const VkSubmitInfo submitInfo{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = (waitSemaphoreValues.has_value() || signalSemaphoreValues.has_value())
+            ? &timelineInfo : nullptr,
         .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
         .pWaitSemaphores = waitSemaphores.data(),
         .pWaitDstStageMask = waitStages.data(),
@@ -87,5 +110,6 @@ void CommandBuffer::submit(VkQueue queue,
     if (res != VK_SUCCESS)
         throw LSFG::vulkan_error(res, "Unable to submit command buffer");
 
-    *this->state = CommandBufferState::Submitted;
+    if (*this->usage & VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+        *this->state = CommandBufferState::Submitted;
 }
@@ -1,4 +1,5 @@
 #include "mini/commandpool.hpp"
+#include "mini/counter.hpp"
 #include "common/exception.hpp"
 #include "layer.hpp"
 
@@ -20,6 +21,8 @@ CommandPool::CommandPool(VkDevice device, uint32_t graphicsFamilyIdx) {
     if (res != VK_SUCCESS || commandPoolHandle == VK_NULL_HANDLE)
         throw LSFG::vulkan_error(res, "Unable to create command pool");
 
+    countObject();
+
     // store command pool in shared ptr
     this->commandPool = std::shared_ptr<VkCommandPool>(
         new VkCommandPool(commandPoolHandle),
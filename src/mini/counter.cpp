@@ -0,0 +1,16 @@
+#include "mini/counter.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace {
+    thread_local size_t objectCount{0}; // per thread, as contexts are built in the background
+}
+
+void Mini::countObject() noexcept {
+    objectCount++;
+}
+
+size_t Mini::takeObjectCount() noexcept {
+    return std::exchange(objectCount, 0);
+}
@@ -1,4 +1,5 @@
 #include "mini/image.hpp"
+#include "mini/counter.hpp"
 #include "common/exception.hpp"
 #include "layer.hpp"
 
@@ -21,7 +22,7 @@ Image::Image(VkDevice device, VkPhysicalDevice physicalDevice,
     };
     const VkImageCreateInfo desc{
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-        .pNext = &externalInfo,
+        .pNext = fd ? &externalInfo : nullptr,
         .imageType = VK_IMAGE_TYPE_2D,
         .format = format,
         .extent = {
@@ -73,7 +74,7 @@ Image::Image(VkDevice device, VkPhysicalDevice physicalDevice,
     };
     const VkMemoryAllocateInfo allocInfo{
         .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .pNext = &exportInfo,
+        .pNext = fd ? static_cast<const void*>(&exportInfo) : &dedicatedInfo,
         .allocationSize = memReqs.size,
         .memoryTypeIndex = memType.value()
     };
@@ -87,14 +88,18 @@ Image::Image(VkDevice device, VkPhysicalDevice physicalDevice,
         throw LSFG::vulkan_error(res, "Failed to bind memory to Vulkan image");
 
     // obtain the sharing fd
-    const VkMemoryGetFdInfoKHR fdInfo{
-        .sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR,
-        .memory = memoryHandle,
-        .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR,
-    };
-    res = Layer::ovkGetMemoryFdKHR(device, &fdInfo, fd);
-    if (res != VK_SUCCESS || *fd < 0)
-        throw LSFG::vulkan_error(res, "Failed to obtain sharing fd for Vulkan image");
+    if (fd) {
+        const VkMemoryGetFdInfoKHR fdInfo{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR,
+            .memory = memoryHandle,
+            .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR,
+        };
+        res = Layer::ovkGetMemoryFdKHR(device, &fdInfo, fd);
+        if (res != VK_SUCCESS || *fd < 0)
+            throw LSFG::vulkan_error(res, "Failed to obtain sharing fd for Vulkan image");
+    }
+
+    countObject();
 
     // store objects in shared ptr
     this->image = std::shared_ptr<VkImage>(
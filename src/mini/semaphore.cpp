@@ -1,14 +1,16 @@
 #include "mini/semaphore.hpp"
+#include "mini/counter.hpp"
 #include "common/exception.hpp"
 #include "layer.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <memory>
 
 using namespace Mini;
 
-Semaphore::Semaphore(VkDevice device) {
+Semaphore::Semaphore(VkDevice device) : device(device) {
     // create semaphore
     const VkSemaphoreCreateInfo desc{
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
@@ -18,6 +20,8 @@ Semaphore::Semaphore(VkDevice device) {
     if (res != VK_SUCCESS || semaphoreHandle == VK_NULL_HANDLE)
         throw LSFG::vulkan_error(res, "Unable to create semaphore");
 
+    countObject();
+
     // store semaphore in shared ptr
     this->semaphore = std::shared_ptr<VkSemaphore>(
         new VkSemaphore(semaphoreHandle),
@@ -27,10 +31,16 @@ Semaphore::Semaphore(VkDevice device) {
     );
 }
 
-Semaphore::Semaphore(VkDevice device, int* fd) {
+Semaphore::Semaphore(VkDevice device, int* fd, bool timeline) : device(device) {
     // create semaphore
+    const VkSemaphoreTypeCreateInfo typeInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0
+    };
     const VkExportSemaphoreCreateInfo exportInfo{
         .sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO,
+        .pNext = timeline ? &typeInfo : nullptr,
         .handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT
     };
     const VkSemaphoreCreateInfo desc{
@@ -42,15 +52,7 @@ Semaphore::Semaphore(VkDevice device, int* fd) {
     if (res != VK_SUCCESS || semaphoreHandle == VK_NULL_HANDLE)
         throw LSFG::vulkan_error(res, "Unable to create semaphore");
 
-    // export semaphore to fd
-    const VkSemaphoreGetFdInfoKHR fdInfo{
-        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
-        .semaphore = semaphoreHandle,
-        .handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT
-    };
-    res = Layer::ovkGetSemaphoreFdKHR(device, &fdInfo, fd);
-    if (res != VK_SUCCESS || *fd < 0)
-        throw LSFG::vulkan_error(res, "Unable to export semaphore to fd");
+    countObject();
 
     // store semaphore in shared ptr
     this->semaphore = std::shared_ptr<VkSemaphore>(
@@ -59,4 +61,42 @@ Semaphore::Semaphore(VkDevice device, int* fd) {
             Layer::ovkDestroySemaphore(dev, *semaphoreHandle, nullptr);
         }
     );
+
+    // export semaphore to fd
+    if (fd)
+        *fd = this->exportFd();
+}
+
+int Semaphore::exportFd() const {
+    const VkSemaphoreGetFdInfoKHR fdInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+        .semaphore = *this->semaphore,
+        .handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT
+    };
+    int fd{-1};
+    auto res = Layer::ovkGetSemaphoreFdKHR(this->device, &fdInfo, &fd);
+    if (res != VK_SUCCESS || fd < 0)
+        throw LSFG::vulkan_error(res, "Unable to export semaphore to fd");
+    return fd;
+}
+
+bool Semaphore::wait(uint64_t value, uint64_t timeout) const {
+    const VkSemaphoreWaitInfo waitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &*this->semaphore,
+        .pValues = &value
+    };
+    auto res = Layer::ovkWaitSemaphores(this->device, &waitInfo, timeout);
+    if (res != VK_SUCCESS && res != VK_TIMEOUT)
+        throw LSFG::vulkan_error(res, "Unable to wait for semaphore");
+    return res == VK_SUCCESS;
+}
+
+uint64_t Semaphore::getValue() const {
+    uint64_t value{};
+    auto res = Layer::ovkGetSemaphoreCounterValue(this->device, *this->semaphore, &value);
+    if (res != VK_SUCCESS)
+        throw LSFG::vulkan_error(res, "Unable to get semaphore value");
+    return value;
 }
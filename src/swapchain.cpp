@@ -0,0 +1,145 @@
+#include "swapchain.hpp"
+#include "common/exception.hpp"
+#include "mini/commandbuffer.hpp"
+#include "mini/commandpool.hpp"
+#include "mini/image.hpp"
+#include "mini/semaphore.hpp"
+#include "utils/utils.hpp"
+#include "hooks.hpp"
+#include "layer.hpp"
+
+#include <vulkan/vulkan_core.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include <array>
+
+bool VirtualSwapchain::isSupported(const VkSwapchainCreateInfoKHR& createInfo) {
+    // mutable formats and layered images would need to be mirrored as well
+    return createInfo.flags == 0
+        && createInfo.imageArrayLayers == 1
+        && createInfo.imageSharingMode == VK_SHARING_MODE_EXCLUSIVE;
+}
+
+VirtualSwapchain::VirtualSwapchain(const Hooks::DeviceInfo& info, VkSwapchainKHR swapchain,
+        const VkSwapchainCreateInfoKHR& createInfo, const std::vector<VkImage>& swapchainImages)
+        : swapchain(swapchain), swapchainImages(swapchainImages) {
+    // create as many images as the game asked for, but at least the two shared ones
+    const VkImageUsageFlags usage = createInfo.imageUsage
+        | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    const size_t imageCount = std::max<size_t>(2, createInfo.minImageCount);
+    for (size_t i = 0; i < imageCount; i++) {
+        const auto& image = this->images.emplace_back(info.device, info.physicalDevice,
+            createInfo.imageExtent, createInfo.imageFormat, usage, VK_IMAGE_ASPECT_COLOR_BIT,
+            i < 2 ? &this->fds.at(i) : nullptr);
+        this->imageHandles.push_back(image.handle());
+    }
+
+    // record copy commands once, they are identical every frame
+    this->cmdPool = Mini::CommandPool(info.device, info.queue.first);
+    for (size_t i = 0; i < this->swapchainImages.size() * 2; i++) {
+        auto& buf = this->copyBufs.emplace_back(info.device, this->cmdPool);
+        buf.begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+        Utils::copyImage(buf.handle(),
+            this->imageHandles.at(i % 2),
+            this->swapchainImages.at(i / 2),
+            createInfo.imageExtent.width, createInfo.imageExtent.height,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            true, true, VK_IMAGE_LAYOUT_UNDEFINED, true);
+        buf.end();
+    }
+
+    for (auto& present : this->presentInfos) {
+        present.acquireSemaphore = Mini::Semaphore(info.device);
+        present.copySemaphore = Mini::Semaphore(info.device);
+    }
+}
+
+uint32_t VirtualSwapchain::acquire(const Hooks::DeviceInfo& info,
+        VkSemaphore semaphore, VkFence fence) {
+    const auto imageIdx = static_cast<uint32_t>(this->acquireIdx % 2);
+    const auto& [timeline, value] = this->releases.at(imageIdx);
+
+    // earlier copies from the image were submitted to the same queue,
+    // so only frame generation has to be waited on
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<uint64_t> waitValues;
+    if (timeline != VK_NULL_HANDLE) {
+        waitSemaphores.push_back(timeline);
+        waitValues.push_back(value);
+    }
+    std::vector<VkSemaphore> signalSemaphores;
+    if (semaphore != VK_NULL_HANDLE)
+        signalSemaphores.push_back(semaphore);
+    Utils::forwardSemaphores(info.queue.second,
+        waitSemaphores, waitValues,
+        signalSemaphores, std::vector<uint64_t>(signalSemaphores.size()),
+        fence);
+
+    this->acquireIdx++;
+    return imageIdx;
+}
+
+VkResult VirtualSwapchain::present(const Hooks::DeviceInfo& info, const void* pNext,
+        VkQueue queue,
+        const std::vector<VkSemaphore>& waitSemaphores, const std::vector<uint64_t>& waitValues,
+        uint32_t imageIdx) {
+    if (imageIdx >= 2)
+        throw LSFG::vulkan_error(VK_ERROR_UNKNOWN, "Virtual image was never acquired");
+    auto& present = this->presentInfos.at(this->presentIdx % 8);
+
+    // 1. acquire the next swapchain image
+    uint32_t swapchainIdx{};
+    auto res = Layer::ovkAcquireNextImageKHR(info.device, this->swapchain, UINT64_MAX,
+        present.acquireSemaphore.handle(), VK_NULL_HANDLE, &swapchainIdx);
+    if (res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR)
+        throw LSFG::vulkan_error(res, "Failed to acquire next swapchain image");
+
+    // 2. copy the virtual image into it
+    std::vector<VkSemaphore> copyWaitSemaphores = waitSemaphores;
+    std::vector<uint64_t> copyWaitValues = waitValues;
+    copyWaitValues.resize(copyWaitSemaphores.size());
+    copyWaitSemaphores.push_back(present.acquireSemaphore.handle());
+    copyWaitValues.push_back(0);
+    this->copyBufs.at(swapchainIdx * 2 + imageIdx).submit(info.queue.second,
+        copyWaitSemaphores, copyWaitValues,
+        { present.copySemaphore.handle() }, std::nullopt);
+
+    // 3. present the swapchain image
+    VkSemaphore copySemaphore = present.copySemaphore.handle();
+    const VkPresentInfoKHR presentInfo{
+        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+        .pNext = pNext,
+        .waitSemaphoreCount = 1,
+        .pWaitSemaphores = &copySemaphore,
+        .swapchainCount = 1,
+        .pSwapchains = &this->swapchain,
+        .pImageIndices = &swapchainIdx,
+    };
+    res = Layer::ovkQueuePresentKHR(queue, &presentInfo);
+    if (res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR)
+        throw LSFG::vulkan_error(res, "Failed to present swapchain image");
+
+    this->presentIdx++;
+    return res;
+}
+
+void VirtualSwapchain::release(uint32_t imageIdx, VkSemaphore timeline, uint64_t value) {
+    this->releases.at(imageIdx) = { timeline, value };
+}
+
+std::array<int, 2> VirtualSwapchain::takeFds() {
+    const auto fds = this->fds;
+    this->fds = { -1, -1 };
+    return fds;
+}
+
+VirtualSwapchain::~VirtualSwapchain() {
+    for (const int fd : this->fds)
+        if (fd >= 0)
+            close(fd);
+}
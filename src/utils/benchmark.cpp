@@ -1,7 +1,8 @@
 #include "utils/benchmark.hpp"
 #include "config/config.hpp"
 #include "extract/extract.hpp"
-#include "extract/trans.hpp"
+#include "extract/batch.hpp"
+#include "utils/utils.hpp"
 
 #include <vulkan/vulkan_core.h>
 #include <lsfg_3_1.hpp>
@@ -12,6 +13,7 @@
 #include <cstdlib>
 #include <cstdint>
 #include <iomanip>
+#include <ctime>
 #include <thread>
 #include <chrono>
 #include <string>
@@ -19,16 +21,28 @@
 
 using namespace Benchmark;
 
+namespace {
+    /// Get the CPU time consumed by the calling thread in nanoseconds.
+    uint64_t threadCpuTime() {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+            + static_cast<uint64_t>(ts.tv_nsec);
+    }
+}
+
 void Benchmark::run(uint32_t width, uint32_t height) {
     const auto& conf = Config::activeConf;
 
     auto* lsfgInitialize = LSFG_3_1::initialize;
     auto* lsfgCreateContext = LSFG_3_1::createContext;
     auto* lsfgPresentContext = LSFG_3_1::presentContext;
+    auto* lsfgGetBarrierCount = LSFG_3_1::getBarrierCount;
     if (conf.performance) {
         lsfgInitialize = LSFG_3_1P::initialize;
         lsfgCreateContext = LSFG_3_1P::createContext;
         lsfgPresentContext = LSFG_3_1P::presentContext;
+        lsfgGetBarrierCount = LSFG_3_1P::getBarrierCount;
     }
 
     // create the benchmark context
@@ -38,30 +52,42 @@ void Benchmark::run(uint32_t width, uint32_t height) {
 
     setenv("DISABLE_LSFG", "1", 1); // NOLINT
 
-    Extract::extractShaders();
+    Extract::extractShaders(conf.dll);
+    const auto setupStart = std::chrono::high_resolution_clock::now();
     lsfgInitialize(
         deviceUUID, // some magic number if not given
-        conf.hdr, 1.0F / conf.flowScale, conf.multiplier - 1,
-        [](const std::string& name) -> std::vector<uint8_t> {
-            auto dxbc = Extract::getShader(name);
-            auto spirv = Extract::translateShader(dxbc);
-            return spirv;
-        }
+        conf.hdr, 1.0F / conf.flowScale, conf.multiplier - 1, false, false,
+        conf.multiQueue, conf.pipelined,
+        Extract::createShaderLoader(conf.performance),
+        Utils::getCacheDirectory()
     );
+    const auto setupInit = std::chrono::high_resolution_clock::now();
+    const VkFormat format = conf.hdr ? VK_FORMAT_R16G16B16A16_SFLOAT : VK_FORMAT_R8G8B8A8_UNORM;
     const int32_t ctx = lsfgCreateContext(-1, -1, {},
         { .width = width, .height = height },
-        conf.hdr ? VK_FORMAT_R16G16B16A16_SFLOAT : VK_FORMAT_R8G8B8A8_UNORM
+        format, format,
+        -1, -1
     );
+    const auto setupEnd = std::chrono::high_resolution_clock::now();
 
     unsetenv("DISABLE_LSFG"); // NOLINT
 
-    // run the benchmark (run 8*n + 1 so the fences are waited on)
+    // print setup times (run twice to compare a cold and a warm pipeline cache)
+    const auto initMs = std::chrono::duration_cast<std::chrono::milliseconds>(setupInit - setupStart).count();
+    const auto ctxMs = std::chrono::duration_cast<std::chrono::milliseconds>(setupEnd - setupInit).count();
+    std::cerr << "lsfg-vk: Initialized in " << initMs << " ms, context created in "
+              << ctxMs << " ms\n";
+
+    // run the benchmark (run 8*n + 1 so the semaphores are waited on)
     const auto now = std::chrono::high_resolution_clock::now();
     const uint64_t iterations = 8 * 500UL;
 
     std::cerr << "lsfg-vk: Benchmark started, running " << iterations << " iterations...\n";
+    uint64_t cpuNs = 0;
     for (uint64_t count = 0; count < iterations + 1; count++) {
-        lsfgPresentContext(ctx, -1, {});
+        const uint64_t cpuStart = threadCpuTime();
+        lsfgPresentContext(ctx, conf.multiplier - 1, {});
+        cpuNs += threadCpuTime() - cpuStart;
 
         if (count % 50 == 0 && count > 0)
             std::cerr << "lsfg-vk: "
@@ -83,8 +109,13 @@ void Benchmark::run(uint32_t width, uint32_t height) {
     const auto totalFps = static_cast<float>(totalFrames) / (static_cast<float>(ms) / 1000.0F);
 
     std::cerr << "lsfg-vk: Benchmark completed in " << ms << " ms\n";
+    const auto cpuPerPresent = static_cast<float>(cpuNs) / static_cast<float>(iterations + 1) / 1000.0F;
+
     std::cerr << "  Time taken per real frame: "
               << std::setprecision(2) << std::fixed << perIteration << " ms\n";
+    std::cerr << "  CPU time per present: "
+              << std::setprecision(2) << std::fixed << cpuPerPresent << " us\n";
+    std::cerr << "  Pipeline barriers per real frame: " << lsfgGetBarrierCount(ctx) << "\n";
     std::cerr << "  Generated " << totalGen << " frames in total at "
               << std::setprecision(2) << std::fixed << genFps << " FPS\n";
     std::cerr << "  Total of " << totalFrames << " frames presented at "
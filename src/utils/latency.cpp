@@ -0,0 +1,79 @@
+#include "utils/latency.hpp"
+#include "utils/pacing.hpp"
+#include "mini/semaphore.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+
+using namespace Latency;
+
+namespace {
+    /// Interval between latency reports.
+    constexpr std::chrono::nanoseconds REPORT_INTERVAL = std::chrono::seconds(10);
+    /// Give up on holding the game after this long, for example while shaders compile.
+    constexpr uint64_t WAIT_TIMEOUT = 1000ULL * 1000 * 1000;
+
+    double toMilliseconds(std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+}
+
+Limiter::Limiter(Pacing::Clock clock) : clock(std::move(clock)) {}
+
+void Limiter::observe(const Mini::Semaphore& timeline, uint64_t frame,
+        uint64_t generationCount, std::chrono::nanoseconds time) {
+    const uint64_t generated = std::min(timeline.getValue() / generationCount, frame + 1);
+    const uint64_t oldest = generated > this->presentTimes.size()
+        ? generated - this->presentTimes.size() : 0;
+    for (uint64_t i = std::max(this->generated, oldest); i < generated; i++) {
+        this->latencySum += time - this->presentTimes.at(i % this->presentTimes.size());
+        this->latencyCount++;
+    }
+    this->generated = std::max(this->generated, generated);
+}
+
+void Limiter::limit(const Mini::Semaphore& timeline, uint64_t frame,
+        uint64_t generationCount, size_t maxFrames) {
+    const auto presented = this->clock.now();
+    this->presentTimes.at(frame % this->presentTimes.size()) = presented;
+    if (this->reportStart.count() == 0)
+        this->reportStart = presented;
+
+    // frames that finished since the last call, at the latest by now
+    this->observe(timeline, frame, generationCount, presented);
+
+    // hold the game until it is at most maxFrames ahead. the wait returns as the frame
+    // it waits for is generated, which times that frame precisely.
+    maxFrames = std::clamp<size_t>(maxFrames, 1, this->presentTimes.size());
+    if (frame + 1 >= maxFrames && this->generated < frame + 2 - maxFrames) {
+        (void)timeline.wait((frame + 2 - maxFrames) * generationCount, WAIT_TIMEOUT);
+        this->observe(timeline, frame, generationCount, this->clock.now());
+    }
+    const auto now = this->clock.now();
+    this->waitSum += now - presented;
+    this->frameCount++;
+
+    // report measured latency
+    if (now - this->reportStart < REPORT_INTERVAL || this->latencyCount == 0)
+        return;
+
+    std::ostringstream report; // keep the formatting flags off std::cerr
+    report << std::fixed << std::setprecision(2)
+        << "lsfg-vk: Frame generation latency: "
+        << toMilliseconds(this->latencySum / static_cast<int64_t>(this->latencyCount))
+        << "ms, limiter waited "
+        << toMilliseconds(this->waitSum / static_cast<int64_t>(this->frameCount))
+        << "ms per frame\n";
+    std::cerr << report.str();
+    this->reportStart = now;
+    this->latencySum = {};
+    this->waitSum = {};
+    this->latencyCount = 0;
+    this->frameCount = 0;
+}
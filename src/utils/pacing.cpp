@@ -0,0 +1,62 @@
+#include "utils/pacing.hpp"
+
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <chrono>
+
+using namespace Pacing;
+
+namespace {
+    /// Frames further apart than this are not paced and reset the estimate.
+    constexpr std::chrono::nanoseconds STALL_THRESHOLD = std::chrono::milliseconds(200);
+    /// Weight of a new sample in the interval estimate, as 1 / n.
+    constexpr int64_t SMOOTHING = 8;
+}
+
+Clock Clock::steady() {
+    return {
+        .now = []() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch());
+        },
+        .sleepUntil = [](std::chrono::nanoseconds time) {
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(time)));
+        }
+    };
+}
+
+Scheduler::Scheduler(Clock clock) : clock(std::move(clock)) {}
+
+void Scheduler::beginFrame() {
+    const auto now = this->clock.now();
+    const auto delta = now - this->frameStart;
+    this->frameStart = now;
+
+    if (this->frameCount++ == 0 || delta > STALL_THRESHOLD) {
+        this->interval = {};
+        this->lastDelta = {};
+        this->frameCount = 1;
+        return;
+    }
+    this->lastDelta = delta;
+
+    // start from the first sample, then smooth out jitter between frames
+    if (this->interval.count() == 0)
+        this->interval = delta;
+    else
+        this->interval += (delta - this->interval) / SMOOTHING;
+}
+
+void Scheduler::waitFor(size_t i, size_t count) const {
+    if (this->interval.count() == 0 || i == 0 || count == 0)
+        return;
+
+    const auto deadline = this->frameStart
+        + this->interval * static_cast<int64_t>(i) / static_cast<int64_t>(count);
+    if (deadline > this->clock.now())
+        this->clock.sleepUntil(deadline);
+}
@@ -0,0 +1,106 @@
+#include "utils/prewarm.hpp"
+#include "config/config.hpp"
+#include "extract/batch.hpp"
+#include "utils/utils.hpp"
+#include "hooks.hpp"
+#include "layer.hpp"
+
+#include <vulkan/vulkan_core.h>
+#include <lsfg_3_1.hpp>
+#include <lsfg_3_1p.hpp>
+
+#include <exception>
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <future>
+#include <chrono>
+#include <mutex>
+
+using namespace Prewarm;
+
+namespace {
+    std::mutex mutex;
+    std::future<void> task;
+    bool started{false};
+    uint64_t prewarmedUUID{};
+
+    /// Initialize LSFG and compile all pipelines by creating a throwaway context.
+    void prewarm(uint64_t deviceUUID, Config::Configuration conf) {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        auto* lsfgInitialize = LSFG_3_1::initialize;
+        auto* lsfgCreateContext = LSFG_3_1::createContext;
+        auto* lsfgDeleteContext = LSFG_3_1::deleteContext;
+        if (conf.performance) {
+            lsfgInitialize = LSFG_3_1P::initialize;
+            lsfgCreateContext = LSFG_3_1P::createContext;
+            lsfgDeleteContext = LSFG_3_1P::deleteContext;
+        }
+
+        // keep the layer out of the instance and device lsfg creates on this thread
+        {
+            const Layer::Bypass bypass;
+            lsfgInitialize(
+                deviceUUID,
+                conf.hdr, 1.0F / conf.flowScale, conf.multiplier - 1, conf.targetFps > 0,
+                conf.pacing && conf.e_presentThread, conf.multiQueue, conf.pipelined,
+                Extract::createShaderLoader(conf.performance),
+                Utils::getCacheDirectory()
+            );
+        }
+
+        // the extent only needs to be large enough for every mip level to exist
+        const VkFormat format = conf.hdr
+            ? VK_FORMAT_R8G8B8A8_UNORM
+            : VK_FORMAT_R16G16B16A16_SFLOAT;
+        const int32_t id = lsfgCreateContext(-1, -1, {},
+            { .width = 512, .height = 512 }, format, format, -1, -1);
+        lsfgDeleteContext(id);
+
+        const auto total = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+        std::cerr << "lsfg-vk: Pre-warmed frame generation in "
+                  << std::setprecision(2) << std::fixed
+                  << static_cast<float>(total.count()) / 1000.0F << " ms\n";
+    }
+}
+
+void Prewarm::start(const Hooks::DeviceInfo& info) {
+    const auto& conf = Config::activeConf;
+    if (!conf.enable || conf.multiplier <= 1)
+        return;
+
+    const std::scoped_lock lock(mutex);
+    if (started)
+        return; // only the first device is pre-warmed
+    started = true;
+
+    // layer function pointers are resolved here, not on the worker
+    prewarmedUUID = Utils::getDeviceUUID(info.physicalDevice);
+    try {
+        task = std::async(std::launch::async, prewarm, prewarmedUUID, conf);
+    } catch (const std::exception& e) {
+        std::cerr << "lsfg-vk: Unable to start pre-warming frame generation:\n";
+        std::cerr << "- " << e.what() << '\n';
+    }
+}
+
+void Prewarm::wait(const Hooks::DeviceInfo& info) noexcept {
+    const std::scoped_lock lock(mutex);
+    if (!task.valid())
+        return;
+
+    try {
+        task.get();
+    } catch (const std::exception& e) {
+        std::cerr << "lsfg-vk: Pre-warming frame generation failed, continuing without:\n";
+        std::cerr << "- " << e.what() << '\n';
+    }
+
+    // the game may present on a different device than the one it created first
+    if (Utils::getDeviceUUID(info.physicalDevice) != prewarmedUUID) {
+        LSFG_3_1P::finalize();
+        LSFG_3_1::finalize();
+    }
+}
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <mutex>
 
 using namespace Utils;
 
@@ -93,11 +94,14 @@ void Utils::copyImage(VkCommandBuffer buf,
         VkImage src, VkImage dst,
         uint32_t width, uint32_t height,
         VkPipelineStageFlags pre, VkPipelineStageFlags post,
-        bool makeSrcPresentable, bool makeDstPresentable) {
+        bool makeSrcPresentable, bool makeDstPresentable,
+        VkImageLayout restingLayout, bool sameFormat) {
+    const bool tracked = restingLayout != VK_IMAGE_LAYOUT_UNDEFINED;
     const VkImageMemoryBarrier srcBarrier{
         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
         .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        .oldLayout = (tracked && !makeSrcPresentable)
+            ? restingLayout : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
         .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
         .image = src,
         .subresourceRange = {
@@ -123,31 +127,52 @@ void Utils::copyImage(VkCommandBuffer buf,
         0, nullptr, 0, nullptr,
         static_cast<uint32_t>(barriers.size()), barriers.data());
 
-    const VkImageBlit imageBlit{
-        .srcSubresource = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .layerCount = 1
-        },
-        .srcOffsets = {
-            { 0, 0, 0 },
-            { static_cast<int32_t>(width), static_cast<int32_t>(height), 1 }
-        },
-        .dstSubresource = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .layerCount = 1
-        },
-        .dstOffsets = {
-            { 0, 0, 0 },
-            { static_cast<int32_t>(width), static_cast<int32_t>(height), 1 }
-        }
-    };
-    Layer::ovkCmdBlitImage(
-        buf,
-        src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1, &imageBlit,
-        VK_FILTER_NEAREST
-    );
+    if (sameFormat) {
+        // a plain copy skips the sampling path blits take for format conversion
+        const VkImageCopy imageCopy{
+            .srcSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .layerCount = 1
+            },
+            .dstSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .layerCount = 1
+            },
+            .extent = { width, height, 1 }
+        };
+        Layer::ovkCmdCopyImage(
+            buf,
+            src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &imageCopy
+        );
+    } else {
+        const VkImageBlit imageBlit{
+            .srcSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .layerCount = 1
+            },
+            .srcOffsets = {
+                { 0, 0, 0 },
+                { static_cast<int32_t>(width), static_cast<int32_t>(height), 1 }
+            },
+            .dstSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .layerCount = 1
+            },
+            .dstOffsets = {
+                { 0, 0, 0 },
+                { static_cast<int32_t>(width), static_cast<int32_t>(height), 1 }
+            }
+        };
+        Layer::ovkCmdBlitImage(
+            buf,
+            src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &imageBlit,
+            VK_FILTER_NEAREST
+        );
+    }
 
     if (makeSrcPresentable) {
         const VkImageMemoryBarrier presentBarrier{
@@ -186,6 +211,74 @@ void Utils::copyImage(VkCommandBuffer buf,
             0, nullptr, 0, nullptr,
             1, &presentBarrier);
     }
+
+    // return the other image to the layout it is kept in
+    if (tracked) {
+        const VkImageMemoryBarrier restBarrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = makeSrcPresentable ? VK_ACCESS_TRANSFER_WRITE_BIT : 0U,
+            .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT,
+            .oldLayout = makeSrcPresentable
+                ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .newLayout = restingLayout,
+            .image = makeSrcPresentable ? dst : src,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .levelCount = 1,
+                .layerCount = 1
+            }
+        };
+        Layer::ovkCmdPipelineBarrier(buf,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, post, 0,
+            0, nullptr, 0, nullptr,
+            1, &restBarrier);
+    }
+}
+
+void Utils::forwardSemaphores(VkQueue queue,
+        const std::vector<VkSemaphore>& waitSemaphores, const std::vector<uint64_t>& waitValues,
+        const std::vector<VkSemaphore>& signalSemaphores, const std::vector<uint64_t>& signalValues,
+        VkFence fence) {
+    const std::vector<VkPipelineStageFlags> waitStages(waitSemaphores.size(),
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    const VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size()),
+        .pWaitSemaphoreValues = waitValues.data(),
+        .signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size()),
+        .pSignalSemaphoreValues = signalValues.data()
+    };
+    const VkSubmitInfo submitInfo{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineInfo,
+        .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
+        .pWaitSemaphores = waitSemaphores.data(),
+        .pWaitDstStageMask = waitStages.data(),
+        .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()),
+        .pSignalSemaphores = signalSemaphores.data()
+    };
+    auto res = Layer::ovkQueueSubmit(queue, 1, &submitInfo, fence);
+    if (res != VK_SUCCESS)
+        throw LSFG::vulkan_error(res, "Unable to forward semaphores");
+}
+
+namespace {
+    /// Queue locks, shared between queues by handle. Locks are only ever taken one at a time
+    /// or all at once in order, so sharing them cannot deadlock.
+    std::array<std::mutex, 16> queueLocks;
+}
+
+std::unique_lock<std::mutex> Utils::lockQueue(VkQueue queue) {
+    const auto handle = reinterpret_cast<uintptr_t>(queue);
+    return std::unique_lock(queueLocks.at((handle >> 4) % queueLocks.size()));
+}
+
+std::vector<std::unique_lock<std::mutex>> Utils::lockAllQueues() {
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(queueLocks.size());
+    for (auto& lock : queueLocks)
+        locks.emplace_back(lock);
+    return locks;
 }
 
 namespace {
@@ -248,3 +341,13 @@ std::string Utils::getConfigFile() {
         return std::string(homePath) + "/.config/lsfg-vk/conf.toml";
     return "/etc/lsfg-vk/conf.toml";
 }
+
+std::string Utils::getCacheDirectory() {
+    const char* xdgPath = std::getenv("XDG_CACHE_HOME");
+    if (xdgPath && *xdgPath != '\0')
+        return std::string(xdgPath) + "/lsfg-vk";
+    const char* homePath = std::getenv("HOME");
+    if (homePath && *homePath != '\0')
+        return std::string(homePath) + "/.cache/lsfg-vk";
+    return "/tmp/lsfg-vk";
+}